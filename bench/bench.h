@@ -0,0 +1,86 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#define _POSIX_C_SOURCE 199309L
+#include "../src/types.h"
+#include <time.h>
+
+#define BENCH_MAX_RESULTS 32
+
+typedef struct bench_result_t
+{
+	const char *name;
+	const char *unit; // what a single operation is
+	uint64_t	operations;
+	float64_t	seconds;
+} bench_result_t;
+
+typedef struct bench_report_t
+{
+	const char	  *suite;
+	bench_result_t results[BENCH_MAX_RESULTS];
+	uint32_t	   results_length;
+} bench_report_t;
+
+static inline float64_t bench_now(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return now.tv_sec + (now.tv_nsec / 1e9);
+}
+
+static inline void bench_add(bench_report_t *report, const char *name, const char *unit, uint64_t operations, float64_t seconds)
+{
+	if (report->results_length >= BENCH_MAX_RESULTS)
+	{
+		return;
+	}
+
+	bench_result_t *result = &report->results[report->results_length++];
+	result->name		   = name;
+	result->unit		   = unit;
+	result->operations	   = operations;
+	result->seconds		   = seconds;
+
+	fprintf(stderr, "%-24s %12.0f %s/s %10.1f ns/%s\n", name, operations / seconds, unit, (seconds * 1e9) / operations, unit);
+}
+
+// writes the report as json to the given file, or to stdout when it's NULL
+static inline bool bench_write_json(const bench_report_t *report, const char *file)
+{
+	FILE *f = file ? fopen(file, "w") : stdout;
+
+	if (!f)
+	{
+		return false;
+	}
+
+	fprintf(f, "{\n\t\"suite\": \"%s\",\n\t\"results\": [\n", report->suite);
+
+	for (uint32_t i = 0; i < report->results_length; i++)
+	{
+		const bench_result_t *result = &report->results[i];
+
+		fprintf(f,
+				"\t\t{ \"name\": \"%s\", \"unit\": \"%s\", \"operations\": %llu, \"seconds\": %.6f, \"per_second\": %.1f, \"ns_per_op\": %.2f }%s\n",
+				result->name,
+				result->unit,
+				(unsigned long long)result->operations,
+				result->seconds,
+				result->operations / result->seconds,
+				(result->seconds * 1e9) / result->operations,
+				i + 1 < report->results_length ? "," : "");
+	}
+
+	fprintf(f, "\t]\n}\n");
+
+	if (file)
+	{
+		fclose(f);
+	}
+
+	return true;
+}
+
+#endif
\ No newline at end of file
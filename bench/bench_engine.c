@@ -0,0 +1,402 @@
+#include "bench.h"
+#include "../src/engine/bot.h"
+#include "../src/engine/engine.h"
+
+#define BENCH_SEED 0x7e7215
+#define BENCH_GAMES 2000
+#define BENCH_PLACEMENTS 2000000
+#define BENCH_STEPS 5000000
+#define BENCH_LINE_CLEARS 500000
+#define BENCH_BOT_GAMES 20
+#define BENCH_BOT_MAX_SHAPES 1000 // the bot rarely loses, games are cut here
+#define BENCH_SHAPES 20000000
+
+static const float32_t	  c_frame_time		 = 1.0 / 20.0;
+static const float32_t	  c_line_clear_delay = 0.5; // longer than the filled rows animation
+static const board_size_t c_board_size_tall	 = { .rows = 40, .cols = 10 };
+static const board_size_t c_board_size_max	 = { .rows = BOARD_ROWS_MAX, .cols = BOARD_COLS_MAX };
+
+static uint32_t next_random(uint32_t *state);
+static int16_t	get_min_pos_x(const engine_t *engine);
+static int16_t	get_max_pos_x(const engine_t *engine);
+static void		place_shape(engine_t *engine, uint8_t rotation, int16_t x);
+static void		place_shape_lowest(engine_t *engine);
+static void		bench_placements(bench_report_t *report, board_size_t board_size, const char *name);
+static void		bench_hard_drops(bench_report_t *report);
+static void		bench_ghost(bench_report_t *report, board_size_t board_size, const char *name);
+static void		bench_line_clears(bench_report_t *report, board_size_t board_size, const char *name);
+static void		bench_line_clears_apart(bench_report_t *report, board_size_t board_size, const char *name);
+static void		bench_steps(bench_report_t *report);
+static void		bench_games(bench_report_t *report);
+static void		bench_bot_games(bench_report_t *report);
+static void		bench_randomizer(bench_report_t *report, randomizer_type_t type, const char *name);
+
+int main(int argc, char *argv[])
+{
+	bench_report_t report = { .suite = "engine" };
+
+	bench_placements(&report, BOARD_SIZE_DEFAULT, "placements");
+	bench_placements(&report, c_board_size_tall, "placements_10x40");
+	bench_placements(&report, c_board_size_max, "placements_64x1000");
+	bench_hard_drops(&report);
+	bench_ghost(&report, BOARD_SIZE_DEFAULT, "ghost");
+	bench_ghost(&report, c_board_size_tall, "ghost_10x40");
+	bench_ghost(&report, c_board_size_max, "ghost_64x1000");
+	bench_line_clears(&report, BOARD_SIZE_DEFAULT, "line_clears");
+	bench_line_clears(&report, c_board_size_tall, "line_clears_10x40");
+	bench_line_clears(&report, c_board_size_max, "line_clears_64x1000");
+	bench_line_clears_apart(&report, BOARD_SIZE_DEFAULT, "line_clears_apart");
+	bench_line_clears_apart(&report, c_board_size_max, "line_clears_apart_64x1000");
+	bench_steps(&report);
+	bench_games(&report);
+	bench_bot_games(&report);
+	bench_randomizer(&report, RANDOMIZER_TYPE_UNIFORM, "shapes_uniform");
+	bench_randomizer(&report, RANDOMIZER_TYPE_BAG, "shapes_bag");
+
+	return bench_write_json(&report, argc > 1 ? argv[1] : NULL) ? 0 : 1;
+}
+
+static uint32_t next_random(uint32_t *state)
+{
+	*state = *state * 1664525 + 1013904223;
+
+	return *state >> 8;
+}
+
+// of the current shape, as it's rotated
+static int16_t get_min_pos_x(const engine_t *engine)
+{
+	return -SHAPE_ROTATION(engine->current_shape)->padding_left;
+}
+
+static int16_t get_max_pos_x(const engine_t *engine)
+{
+	const shape_rotation_t *rotation = SHAPE_ROTATION(engine->current_shape);
+
+	return engine->board_size.cols - rotation->width - rotation->padding_left;
+}
+
+// moves the current shape straight to its column and orientation, then drops it
+static void place_shape(engine_t *engine, uint8_t rotation, int16_t x)
+{
+	engine->current_shape.rotation = rotation;
+	engine->current_shape.pos.x	   = x;
+	engine_step(engine, PLAYER_ACTION_HARD_DROP, c_line_clear_delay);
+}
+
+// greedy placement, the one that lands deepest on the board
+static void place_shape_lowest(engine_t *engine)
+{
+	shape_t *shape			= &engine->current_shape;
+	shape_t	 spawn			= *shape;
+	uint8_t	 best_rotation	= 0;
+	int16_t	 best_x			= shape->pos.x;
+	int16_t	 best_bottom	= -1;
+	int16_t	 max_x			= 0;
+	int16_t	 shape_bottom_y = 0;
+
+	for (uint8_t rotation = 0; rotation < SHAPE_ROTATIONS_COUNT; rotation++)
+	{
+		shape->rotation = rotation;
+		max_x			= get_max_pos_x(engine);
+
+		for (int16_t x = get_min_pos_x(engine); x <= max_x; x++)
+		{
+			shape->pos.x   = x;
+			shape_bottom_y = engine_get_shape_dest_pos_y(engine) + SHAPE_ROTATION(*shape)->padding_top + SHAPE_ROTATION(*shape)->height;
+
+			if (shape_bottom_y > best_bottom)
+			{
+				best_bottom	  = shape_bottom_y;
+				best_rotation = rotation;
+				best_x		  = x;
+			}
+		}
+	}
+
+	*shape = spawn;
+	place_shape(engine, best_rotation, best_x);
+}
+
+static void bench_placements(bench_report_t *report, board_size_t board_size, const char *name)
+{
+	engine_t engine;
+	uint32_t random = BENCH_SEED;
+
+	engine_init(&engine, BENCH_SEED, RANDOMIZER_TYPE_UNIFORM, board_size);
+	float64_t start = bench_now();
+
+	for (uint32_t i = 0; i < BENCH_PLACEMENTS; i++)
+	{
+		if (engine_is_game_over(&engine))
+		{
+			engine_dispose(&engine);
+			engine_init(&engine, BENCH_SEED + i, RANDOMIZER_TYPE_UNIFORM, board_size);
+		}
+
+		shape_t *shape = &engine.current_shape;
+		shape->rotation = next_random(&random) % SHAPE_ROTATIONS_COUNT;
+		int16_t min_x	= get_min_pos_x(&engine);
+		int16_t x		= min_x + next_random(&random) % (get_max_pos_x(&engine) - min_x + 1);
+
+		place_shape(&engine, shape->rotation, x);
+	}
+
+	bench_add(report, name, "placement", BENCH_PLACEMENTS, bench_now() - start);
+	engine_dispose(&engine);
+}
+
+static void bench_hard_drops(bench_report_t *report)
+{
+	engine_t engine;
+
+	engine_init(&engine, BENCH_SEED, RANDOMIZER_TYPE_UNIFORM, BOARD_SIZE_DEFAULT);
+	float64_t start = bench_now();
+
+	for (uint32_t i = 0; i < BENCH_PLACEMENTS; i++)
+	{
+		if (engine_is_game_over(&engine))
+		{
+			engine_dispose(&engine);
+			engine_init(&engine, BENCH_SEED + i, RANDOMIZER_TYPE_UNIFORM, BOARD_SIZE_DEFAULT);
+		}
+
+		engine_step(&engine, PLAYER_ACTION_HARD_DROP, 0);
+	}
+
+	bench_add(report, "hard_drops", "drop", BENCH_PLACEMENTS, bench_now() - start);
+	engine_dispose(&engine);
+}
+
+// ghost (shadow) position for every reachable column and orientation, on the
+// boards of a game played with the greedy placement
+static void bench_ghost(bench_report_t *report, board_size_t board_size, const char *name)
+{
+	engine_t  engine;
+	uint64_t  operations = 0;
+	float64_t seconds	 = 0;
+	int16_t	  checksum	 = 0;
+
+	engine_init(&engine, BENCH_SEED, RANDOMIZER_TYPE_UNIFORM, board_size);
+
+	while (operations < BENCH_STEPS)
+	{
+		if (engine_is_game_over(&engine))
+		{
+			engine_dispose(&engine);
+			engine_init(&engine, BENCH_SEED + operations, RANDOMIZER_TYPE_UNIFORM, board_size);
+		}
+
+		shape_t	 *shape = &engine.current_shape;
+		shape_t	  spawn = *shape;
+		float64_t start = bench_now();
+
+		for (uint8_t rotation = 0; rotation < SHAPE_ROTATIONS_COUNT; rotation++)
+		{
+			shape->rotation = rotation;
+			int16_t max_x	= get_max_pos_x(&engine);
+
+			for (int16_t x = get_min_pos_x(&engine); x <= max_x; x++)
+			{
+				shape->pos.x = x;
+				checksum += engine_get_shape_dest_pos_y(&engine);
+				operations++;
+			}
+		}
+
+		seconds += bench_now() - start;
+		*shape = spawn;
+		place_shape_lowest(&engine);
+	}
+
+	bench_add(report, name, "ghost", operations, seconds);
+	engine_dispose(&engine);
+
+	if (checksum == INT16_MIN)
+	{
+		fprintf(stderr, "unreachable checksum %d\n", checksum);
+	}
+}
+
+// four rows filled but the left column, cleared by a vertical I shape
+static void bench_line_clears(bench_report_t *report, board_size_t board_size, const char *name)
+{
+	engine_t  engine;
+	uint64_t  lines	  = 0;
+	float64_t seconds = 0;
+
+	engine_init(&engine, BENCH_SEED, RANDOMIZER_TYPE_UNIFORM, board_size);
+
+	while (lines < BENCH_LINE_CLEARS)
+	{
+		for (uint16_t y = board_size.rows - 4; y < board_size.rows; y++)
+		{
+			engine.board[y] = engine.board_row_full & ~1;
+			memset(engine.board_colors + (y * board_size.cols) + 1, COLOR_PAIR_WHITE_DEFAULT, board_size.cols - 1);
+		}
+
+		engine.board_top_row_filled = board_size.rows - 4;
+		engine.current_shape.type	= SHAPE_TYPE_I;
+		engine.score				= 0;
+
+		float64_t start = bench_now();
+
+		place_shape(&engine, 0, 0);
+
+		seconds += bench_now() - start;
+		lines += engine.score;
+
+		if (engine.score == 0)
+		{
+			fprintf(stderr, "line_clears: rows were not cleared\n");
+			break;
+		}
+	}
+
+	bench_add(report, name, "line", lines, seconds);
+	engine_dispose(&engine);
+}
+
+// two full rows with a row left between them, which has to end up right
+// above the row below and not leave a full row behind
+static void bench_line_clears_apart(bench_report_t *report, board_size_t board_size, const char *name)
+{
+	engine_t  engine;
+	uint64_t  lines	  = 0;
+	float64_t seconds = 0;
+
+	engine_init(&engine, BENCH_SEED, RANDOMIZER_TYPE_UNIFORM, board_size);
+
+	while (lines < BENCH_LINE_CLEARS)
+	{
+		for (uint16_t y = board_size.rows - 4; y < board_size.rows; y++)
+		{
+			// odd rows are completed by the shape, even ones keep a hole
+			engine.board[y] = engine.board_row_full & ~(y % 2 ? 1 : 3);
+			memset(engine.board_colors + (y * board_size.cols), 0, board_size.cols);
+			memset(engine.board_colors + (y * board_size.cols) + (y % 2 ? 1 : 2), COLOR_PAIR_WHITE_DEFAULT, board_size.cols - (y % 2 ? 1 : 2));
+		}
+
+		engine.board_top_row_filled = board_size.rows - 4;
+		engine.current_shape.type	= SHAPE_TYPE_I;
+		engine.score				= 0;
+
+		float64_t start = bench_now();
+
+		place_shape(&engine, 0, 0);
+
+		seconds += bench_now() - start;
+		lines += engine.score;
+
+		ASSERT(engine.score == 2);
+
+		for (uint16_t y = engine.board_top_row_filled; y < board_size.rows; y++)
+		{
+			ASSERT(engine.board[y] != engine.board_row_full);
+		}
+	}
+
+	bench_add(report, name, "line", lines, seconds);
+	engine_dispose(&engine);
+}
+
+// frames without player input, mostly gravity
+static void bench_steps(bench_report_t *report)
+{
+	engine_t engine;
+
+	engine_init(&engine, BENCH_SEED, RANDOMIZER_TYPE_UNIFORM, BOARD_SIZE_DEFAULT);
+	float64_t start = bench_now();
+
+	for (uint32_t i = 0; i < BENCH_STEPS; i++)
+	{
+		if (engine_is_game_over(&engine))
+		{
+			engine_dispose(&engine);
+			engine_init(&engine, BENCH_SEED + i, RANDOMIZER_TYPE_UNIFORM, BOARD_SIZE_DEFAULT);
+		}
+
+		engine_step(&engine, PLAYER_ACTION_IDLE, c_frame_time);
+	}
+
+	bench_add(report, "idle_steps", "step", BENCH_STEPS, bench_now() - start);
+	engine_dispose(&engine);
+}
+
+static void bench_games(bench_report_t *report)
+{
+	engine_t engine;
+	uint64_t shapes = 0;
+	uint64_t lines	= 0;
+
+	float64_t start = bench_now();
+
+	for (uint32_t i = 0; i < BENCH_GAMES; i++)
+	{
+		engine_init(&engine, BENCH_SEED + i, RANDOMIZER_TYPE_UNIFORM, BOARD_SIZE_DEFAULT);
+
+		while (!engine_is_game_over(&engine))
+		{
+			place_shape_lowest(&engine);
+		}
+
+		shapes += engine.shapes_count;
+		lines += engine.score;
+		engine_dispose(&engine);
+	}
+
+	float64_t seconds = bench_now() - start;
+
+	bench_add(report, "games", "game", BENCH_GAMES, seconds);
+	bench_add(report, "games_placements", "placement", shapes, seconds);
+	bench_add(report, "games_lines", "line", lines, seconds);
+}
+
+// headless bot, placement choice included
+static void bench_bot_games(bench_report_t *report)
+{
+	engine_t engine;
+	bot_t	 bot;
+	uint64_t shapes = 0;
+	uint64_t lines	= 0;
+
+	float64_t start = bench_now();
+
+	for (uint32_t i = 0; i < BENCH_BOT_GAMES; i++)
+	{
+		engine_init(&engine, BENCH_SEED + i, RANDOMIZER_TYPE_UNIFORM, BOARD_SIZE_DEFAULT);
+		bot_init(&bot);
+
+		while (!engine_is_game_over(&engine) && engine.shapes_count < BENCH_BOT_MAX_SHAPES)
+		{
+			bot_play_shape(&bot, &engine);
+		}
+
+		shapes += engine.shapes_count;
+		lines += engine.score;
+		engine_dispose(&engine);
+	}
+
+	float64_t seconds = bench_now() - start;
+
+	bench_add(report, "bot_placements", "placement", shapes, seconds);
+	bench_add(report, "bot_lines", "line", lines, seconds);
+}
+
+// shape generation alone, the checksum keeps it from being optimized out
+static void bench_randomizer(bench_report_t *report, randomizer_type_t type, const char *name)
+{
+	randomizer_t randomizer;
+	uint32_t	 checksum = 0;
+
+	randomizer_init(&randomizer, BENCH_SEED, type);
+	float64_t start = bench_now();
+
+	for (uint32_t i = 0; i < BENCH_SHAPES; i++)
+	{
+		checksum += randomizer_next(&randomizer);
+	}
+
+	bench_add(report, name, "shape", BENCH_SHAPES, bench_now() - start);
+	ASSERT(checksum > 0);
+}
\ No newline at end of file
@@ -0,0 +1,182 @@
+#include "bench.h"
+#include "../src/common.h"
+#include "../src/input.h"
+
+#define BENCH_UPDATES 2000000 // float times still have ms precision at the end
+#define BENCH_FRAME_TIME 0.01
+#define BENCH_EVENTS_CAPACITY 64
+
+// a key sent by the terminal at a time
+typedef struct key_event_t
+{
+	float32_t time;
+	int		  key;
+} key_event_t;
+
+static const input_repeat_config_t c_repeat_config		  = { .das = 0.167, .arr = 0.033 };
+static const int				   c_versus_repeat_keys[] = { CH_LEFT, CH_RIGHT, CH_DOWN, CH_P1_LEFT_L, CH_P1_RIGHT_L, CH_P1_DOWN_L };
+
+static uint32_t play_events(const key_event_t *events, uint8_t events_count, float32_t end_time, int key, bool versus);
+static uint8_t	get_held_key_events(key_event_t *events, int key);
+static void		check_double_tap(void);
+static void		check_triple_tap(void);
+static void		check_slow_double_tap(void);
+static void		check_held_key(void);
+static void		check_versus_repeat_keys(void);
+static void		check_alternating_taps(void);
+static void		bench_updates(bench_report_t *report);
+
+int main(int argc, char *argv[])
+{
+	bench_report_t report = { .suite = "input" };
+
+	check_double_tap();
+	check_triple_tap();
+	check_slow_double_tap();
+	check_held_key();
+	check_versus_repeat_keys();
+	check_alternating_taps();
+	bench_updates(&report);
+
+	return bench_write_json(&report, argc > 1 ? argv[1] : NULL) ? 0 : 1;
+}
+
+// updates every BENCH_FRAME_TIME up to end_time with the events due, the
+// times the key was read. Versus auto repeats the first player's keys too
+static uint32_t play_events(const key_event_t *events, uint8_t events_count, float32_t end_time, int key, bool versus)
+{
+	int		 pending[BENCH_EVENTS_CAPACITY];
+	uint8_t	 next_event = 0;
+	uint32_t count		= 0;
+
+	input_init(&c_repeat_config);
+
+	if (versus)
+	{
+		input_set_repeat_keys(c_versus_repeat_keys, sizeof(c_versus_repeat_keys) / sizeof(c_versus_repeat_keys[0]));
+	}
+
+	for (uint32_t frame = 0; frame * BENCH_FRAME_TIME <= end_time; frame++)
+	{
+		float32_t now			= frame * BENCH_FRAME_TIME;
+		uint8_t	  pending_count = 0;
+
+		while (next_event < events_count && events[next_event].time <= now + (BENCH_FRAME_TIME / 2))
+		{
+			pending[pending_count++] = events[next_event++].key;
+		}
+
+		input_update_keys(pending, pending_count, now);
+
+		for (uint8_t i = 0; i < input_get_keys_count(); i++)
+		{
+			count += input_get_key(i) == key;
+		}
+	}
+
+	return count;
+}
+
+// the terminal repeats after 0.5s every 30ms up to 1s
+static uint8_t get_held_key_events(key_event_t *events, int key)
+{
+	uint8_t events_count = 0;
+
+	events[events_count++] = (key_event_t){ 0.0, key };
+
+	for (float32_t time = 0.5; time <= 1.0; time += 0.03)
+	{
+		events[events_count++] = (key_event_t){ time, key };
+	}
+
+	return events_count;
+}
+
+// both taps move, without any auto repeat
+static void check_double_tap(void)
+{
+	key_event_t events[] = { { 0.0, CH_LEFT }, { 0.08, CH_LEFT } };
+
+	ASSERT(play_events(events, 2, 1.5, CH_LEFT, false) == 2);
+}
+
+static void check_triple_tap(void)
+{
+	key_event_t events[] = { { 0.0, CH_RIGHT }, { 0.06, CH_RIGHT }, { 0.12, CH_RIGHT } };
+
+	ASSERT(play_events(events, 3, 1.5, CH_RIGHT, false) == 3);
+}
+
+// the second tap comes a terminal repeat delay after the first one, it only
+// moves once no repeat follows it
+static void check_slow_double_tap(void)
+{
+	key_event_t events[] = { { 0.0, CH_LEFT }, { 0.3, CH_LEFT } };
+
+	ASSERT(play_events(events, 2, 0.35, CH_LEFT, false) == 1);
+	ASSERT(play_events(events, 2, 1.5, CH_LEFT, false) == 2);
+}
+
+// the press, then arr paced repeats from the first terminal repeat (held
+// back until the next one comes) until one terminal interval past the last
+// repeat
+static void check_held_key(void)
+{
+	key_event_t events[BENCH_EVENTS_CAPACITY];
+	uint8_t		events_count = get_held_key_events(events, CH_LEFT);
+
+	// nothing moves between the press and the second terminal repeat
+	ASSERT(play_events(events, events_count, 0.52, CH_LEFT, false) == 1);
+
+	uint32_t count = play_events(events, events_count, 1.5, CH_LEFT, false);
+
+	// 0.5 to 1.03 at 33ms is 17 repeats, frames round them to 10ms
+	ASSERT(count >= 1 + 15 && count <= 1 + 19);
+}
+
+// 's' is only auto repeated in versus, elsewhere every terminal repeat is a
+// press (the stage's shadow toggle)
+static void check_versus_repeat_keys(void)
+{
+	key_event_t events[BENCH_EVENTS_CAPACITY];
+	uint8_t		events_count = get_held_key_events(events, CH_P1_DOWN_L);
+	uint32_t	count		 = play_events(events, events_count, 1.5, CH_P1_DOWN_L, true);
+
+	ASSERT(play_events(events, events_count, 1.5, CH_P1_DOWN_L, false) == events_count);
+	ASSERT(count >= 1 + 15 && count <= 1 + 19);
+}
+
+// every tap moves, each key is tapped again within a terminal repeat interval
+static void check_alternating_taps(void)
+{
+	key_event_t events[] = {
+		{ 0.0, CH_LEFT },
+		{ 0.05, CH_RIGHT },
+		{ 0.1, CH_LEFT },
+		{ 0.15, CH_RIGHT },
+		{ 0.2, CH_LEFT },
+		{ 0.25, CH_RIGHT },
+	};
+
+	ASSERT(play_events(events, 6, 1.5, CH_LEFT, false) == 3);
+	ASSERT(play_events(events, 6, 1.5, CH_RIGHT, false) == 3);
+}
+
+// a held key, one terminal repeat every 3 updates
+static void bench_updates(bench_report_t *report)
+{
+	int		 key   = CH_DOWN;
+	uint64_t count = 0;
+
+	input_init(&c_repeat_config);
+	float64_t start = bench_now();
+
+	for (uint32_t i = 0; i < BENCH_UPDATES; i++)
+	{
+		input_update_keys(&key, i % 3 == 0, i * BENCH_FRAME_TIME);
+		count += input_get_keys_count();
+	}
+
+	bench_add(report, "updates", "update", BENCH_UPDATES, bench_now() - start);
+	ASSERT(count > 0);
+}
\ No newline at end of file
@@ -0,0 +1,143 @@
+#include "bench.h"
+#include "../src/assets.h"
+#include "../src/data_structures/arena.h"
+#include "../src/data_structures/memory.h"
+#include "../src/engine/engine.h"
+#include "../src/screens/compositor.h"
+#include "../src/screens/render_framebuffer.h"
+#include "../src/screens/screen_stage.h"
+
+#define BENCH_ROWS 50 // the terminal size the game asks for
+#define BENCH_COLS 100
+#define BENCH_FRAMES 100000
+#define BENCH_REDRAWS 20000
+#define BENCH_TEXT_PATH_SIZE 256
+
+// the screens' globals, as main defines them. The bot plays the games
+bool		   g_bot			 = true;
+bool		   g_bag			 = true;
+char		  *g_record_file	 = NULL;
+char		  *g_watch_path		 = NULL;
+board_size_t   g_board_size		 = BOARD_SIZE_DEFAULT;
+float32_t	   g_delta_time		 = 1.0 / 20.0;
+const asset_t *g_asset_splash	 = NULL;
+const asset_t *g_asset_game_over = NULL;
+score_t		   g_score			 = { .current = 0 };
+arena_t		   g_screens_arena;
+
+static bool bench_stage_frames(bench_report_t *report);
+static void bench_stage_redraws(bench_report_t *report);
+static bool write_frame_text(const char *json_file);
+
+int main(int argc, char *argv[])
+{
+	bench_report_t report = { .suite = "render" };
+
+	render_init(render_framebuffer_init(BENCH_ROWS, BENCH_COLS));
+	g_screens_arena = arena_new(16 * 1024);
+	screen_stage_create();
+	screen_stage_init();
+	compositor_flush();
+
+	bool no_allocations = bench_stage_frames(&report);
+	bench_stage_redraws(&report);
+
+	bool written = bench_write_json(&report, argc > 1 ? argv[1] : NULL) && write_frame_text(argc > 1 ? argv[1] : NULL);
+
+	screen_stage_dispose();
+	screen_stage_destroy();
+	arena_dispose(&g_screens_arena);
+	render_framebuffer_dispose();
+
+	return no_allocations && written ? 0 : 1;
+}
+
+// the stage as the game loop runs it, a new game when the bot loses. Frames
+// are timed from update to flush, render from render to flush. Past the
+// first frame (warm-up) a frame doesn't touch the heap, the frames that do
+// are reported by number
+static bool bench_stage_frames(bench_report_t *report)
+{
+	const render_framebuffer_t *framebuffer		  = render_framebuffer_get();
+	uint64_t					cells_changed	  = 0;
+	uint32_t					allocating_frames = 0;
+	float64_t					render_time		  = 0;
+	float64_t					start			  = bench_now();
+
+	for (uint32_t i = 0; i < BENCH_FRAMES; i++)
+	{
+		uint64_t allocations = memory_get_allocations();
+
+		if (screen_stage_is_completed())
+		{
+			screen_stage_dispose();
+			screen_stage_init();
+		}
+
+		screen_stage_update();
+
+		float64_t render_start = bench_now();
+
+		screen_stage_render();
+		compositor_flush();
+		render_time += bench_now() - render_start;
+		cells_changed += framebuffer->cells_changed;
+		allocations = memory_get_allocations() - allocations;
+
+		if (i > 0 && allocations)
+		{
+			fprintf(stderr, "stage frame %u: %llu allocations\n", i, (unsigned long long)allocations);
+			allocating_frames++;
+		}
+	}
+
+	bench_add(report, "stage_frames", "frame", BENCH_FRAMES, bench_now() - start);
+	bench_add(report, "stage_render", "frame", BENCH_FRAMES, render_time);
+	fprintf(stderr, "%-24s %12.1f cells/frame\n", "stage_cells_changed", (float64_t)cells_changed / BENCH_FRAMES);
+
+	return allocating_frames == 0;
+}
+
+// every window drawn again, as after a terminal resize
+static void bench_stage_redraws(bench_report_t *report)
+{
+	float64_t start = bench_now();
+
+	for (uint32_t i = 0; i < BENCH_REDRAWS; i++)
+	{
+		screen_stage_window_resized();
+		compositor_flush();
+	}
+
+	bench_add(report, "stage_redraws", "frame", BENCH_REDRAWS, bench_now() - start);
+}
+
+// the last frame, next to the json (<benchmark>.txt), or to stdout
+static bool write_frame_text(const char *json_file)
+{
+	char path[BENCH_TEXT_PATH_SIZE];
+
+	if (!json_file)
+	{
+		return render_framebuffer_write_text(stdout);
+	}
+
+	const char *extension = strrchr(json_file, '.');
+	int			length	  = extension ? (int)(extension - json_file) : (int)strlen(json_file);
+
+	if (snprintf(path, sizeof(path), "%.*s.txt", length, json_file) >= (int)sizeof(path))
+	{
+		return false;
+	}
+
+	FILE *f = fopen(path, "w");
+
+	if (!f)
+	{
+		return false;
+	}
+
+	bool written = render_framebuffer_write_text(f);
+
+	return fclose(f) == 0 && written;
+}
\ No newline at end of file
@@ -0,0 +1,175 @@
+#include "bench.h"
+#include "../src/data_structures/data_structures.h"
+
+#define BENCH_IDS 20 // board rows, the engine use
+#define BENCH_CYCLES 5000000
+#define BENCH_LOOKUPS 50000000
+#define BENCH_SETS 1000000
+
+typedef FIXED_SPARSE_SET_T(BENCH_IDS) bench_set_t;
+
+static uint32_t next_random(uint32_t *state);
+static void		bench_add_clear(bench_report_t *report);
+static void		bench_contains(bench_report_t *report);
+static void		bench_lifecycle(bench_report_t *report);
+
+// the same work on sparse_set_t (heap) and the fixed capacity one
+int main(int argc, char *argv[])
+{
+	bench_report_t report = { .suite = "sparse_set" };
+
+	bench_add_clear(&report);
+	bench_contains(&report);
+	bench_lifecycle(&report);
+
+	return bench_write_json(&report, argc > 1 ? argv[1] : NULL) ? 0 : 1;
+}
+
+static uint32_t next_random(uint32_t *state)
+{
+	*state = *state * 1664525 + 1013904223;
+
+	return *state >> 8;
+}
+
+// a line clear: a few rows added, each one looked up, then cleared
+static void bench_add_clear(bench_report_t *report)
+{
+	sparse_set_t sparse_set = sparse_set_new(BENCH_IDS);
+	bench_set_t	 fixed_set;
+	uint32_t	 state	  = 1;
+	uint32_t	 checksum = 0;
+
+	float64_t start = bench_now();
+
+	for (uint32_t i = 0; i < BENCH_CYCLES; i++)
+	{
+		for (uint32_t j = 0; j < 4; j++)
+		{
+			sparse_set_add(&sparse_set, next_random(&state) % BENCH_IDS);
+		}
+
+		for (uint32_t id = 0; id < BENCH_IDS; id++)
+		{
+			checksum += SPARSE_SET_CONTAINS(sparse_set, id);
+		}
+
+		sparse_set_clear(&sparse_set);
+	}
+
+	bench_add(report, "add_clear_sparse_set", "cycle", BENCH_CYCLES, bench_now() - start);
+	sparse_set_dispose(&sparse_set);
+
+	FIXED_SPARSE_SET_INIT(fixed_set);
+	state = 1;
+	start = bench_now();
+
+	for (uint32_t i = 0; i < BENCH_CYCLES; i++)
+	{
+		for (uint32_t j = 0; j < 4; j++)
+		{
+			FIXED_SPARSE_SET_ADD(fixed_set, next_random(&state) % BENCH_IDS);
+		}
+
+		for (uint32_t id = 0; id < BENCH_IDS; id++)
+		{
+			checksum -= FIXED_SPARSE_SET_CONTAINS(fixed_set, id);
+		}
+
+		FIXED_SPARSE_SET_CLEAR(fixed_set);
+	}
+
+	bench_add(report, "add_clear_fixed", "cycle", BENCH_CYCLES, bench_now() - start);
+
+	// same ids, so same lookups results
+	ASSERT(checksum == 0);
+}
+
+// rendering: every cell of a filled row checks the set
+static void bench_contains(bench_report_t *report)
+{
+	sparse_set_t sparse_set = sparse_set_new(BENCH_IDS);
+	bench_set_t	 fixed_set;
+	uint32_t	 found = 0;
+
+	FIXED_SPARSE_SET_INIT(fixed_set);
+
+	for (uint32_t id = 0; id < BENCH_IDS; id += 5)
+	{
+		sparse_set_add(&sparse_set, id);
+		FIXED_SPARSE_SET_ADD(fixed_set, id);
+	}
+
+	float64_t start = bench_now();
+
+	for (uint32_t i = 0; i < BENCH_LOOKUPS; i++)
+	{
+		found += SPARSE_SET_CONTAINS(sparse_set, i % BENCH_IDS);
+	}
+
+	bench_add(report, "contains_sparse_set", "lookup", BENCH_LOOKUPS, bench_now() - start);
+	start = bench_now();
+
+	for (uint32_t i = 0; i < BENCH_LOOKUPS; i++)
+	{
+		found -= FIXED_SPARSE_SET_CONTAINS(fixed_set, i % BENCH_IDS);
+	}
+
+	bench_add(report, "contains_fixed", "lookup", BENCH_LOOKUPS, bench_now() - start);
+	sparse_set_dispose(&sparse_set);
+
+	ASSERT(found == 0);
+}
+
+// a set per game (engine_init to engine_dispose)
+static void bench_lifecycle(bench_report_t *report)
+{
+	uint32_t length = 0;
+
+	float64_t start = bench_now();
+
+	for (uint32_t i = 0; i < BENCH_SETS; i++)
+	{
+		sparse_set_t sparse_set = sparse_set_new(BENCH_IDS);
+		sparse_set_add(&sparse_set, i % BENCH_IDS);
+		length += VECTOR_LENGTH(sparse_set.dense);
+		sparse_set_dispose(&sparse_set);
+	}
+
+	bench_add(report, "lifecycle_sparse_set", "set", BENCH_SETS, bench_now() - start);
+	start = bench_now();
+
+	for (uint32_t i = 0; i < BENCH_SETS; i++)
+	{
+		bench_set_t fixed_set;
+		FIXED_SPARSE_SET_INIT(fixed_set);
+		FIXED_SPARSE_SET_ADD(fixed_set, i % BENCH_IDS);
+		// keeps the set from being optimized out, as if an engine held it
+		__asm__ volatile("" : : "r"(&fixed_set) : "memory");
+		length -= FIXED_SPARSE_SET_LENGTH(fixed_set);
+	}
+
+	bench_add(report, "lifecycle_fixed", "set", BENCH_SETS, bench_now() - start);
+
+	// the arena keeps its block across resets, so only the first set allocates
+	arena_t	 arena		 = arena_new(4096);
+	uint64_t allocations = 0;
+	start				 = bench_now();
+
+	for (uint32_t i = 0; i < BENCH_SETS; i++)
+	{
+		sparse_set_t sparse_set = sparse_set_new_in(&arena, BENCH_IDS);
+		sparse_set_add(&sparse_set, i % BENCH_IDS);
+		length += VECTOR_LENGTH(sparse_set.dense);
+		sparse_set_dispose(&sparse_set);
+		arena_reset(&arena);
+
+		allocations = i == 0 ? memory_get_allocations() : allocations;
+	}
+
+	bench_add(report, "lifecycle_sparse_set_arena", "set", BENCH_SETS, bench_now() - start);
+	ASSERT(memory_get_allocations() == allocations);
+	arena_dispose(&arena);
+
+	ASSERT(length == BENCH_SETS);
+}
\ No newline at end of file
@@ -0,0 +1,186 @@
+#define _POSIX_C_SOURCE 200809L
+#include "assets.h"
+#include "common.h"
+#include "data_structures/memory.h"
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const char *data;
+static uint32_t	   size;
+static asset_t	   assets[ASSETS_MAX];
+static uint32_t	   assets_count;
+
+static bool map_file(const char *file);
+static bool load_index(void);
+
+// maps the whole file and checks its index, so lines never point outside it
+bool assets_open(const char *file)
+{
+	if (!map_file(file))
+	{
+		return false;
+	}
+
+	if (!load_index())
+	{
+		assets_close();
+		return false;
+	}
+
+	return true;
+}
+
+void assets_close(void)
+{
+	if (!data)
+	{
+		return;
+	}
+
+#ifdef __linux__
+	munmap((void *)data, size);
+#else
+	memory_free((void *)data);
+#endif
+
+	data		 = NULL;
+	size		 = 0;
+	assets_count = 0;
+}
+
+const asset_t *assets_get(const char *name)
+{
+	for (uint32_t i = 0; i < assets_count; i++)
+	{
+		if (strcmp(assets[i].name, name) == 0)
+		{
+			return &assets[i];
+		}
+	}
+
+	return NULL;
+}
+
+// text of the line (not null terminated), NULL past the last one
+const char *asset_get_line(const asset_t *asset, uint32_t index, uint32_t *length)
+{
+	if (index >= asset->lines_count)
+	{
+		*length = 0;
+		return NULL;
+	}
+
+	*length = asset->lines[index].length;
+
+	return asset->data + asset->lines[index].offset;
+}
+
+#ifdef __linux__
+static bool map_file(const char *file)
+{
+	struct stat info;
+	int			fd = open(file, O_RDONLY);
+
+	if (fd < 0)
+	{
+		return false;
+	}
+
+	if (fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(assets_header_t) || info.st_size > UINT32_MAX)
+	{
+		close(fd);
+		return false;
+	}
+
+	void *mapped = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (mapped == MAP_FAILED)
+	{
+		return false;
+	}
+
+	data = (const char *)mapped;
+	size = (uint32_t)info.st_size;
+
+	return true;
+}
+#else
+// no mmap, read at once instead
+static bool map_file(const char *file)
+{
+	FILE *f = fopen(file, "rb");
+	long  length;
+	char *buffer;
+
+	if (!f)
+	{
+		return false;
+	}
+
+	fseek(f, 0, SEEK_END);
+	length = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	buffer = length >= (long)sizeof(assets_header_t) ? (char *)memory_alloc(length) : NULL;
+
+	if (!buffer || fread(buffer, 1, length, f) != (size_t)length)
+	{
+		memory_free(buffer);
+		fclose(f);
+		return false;
+	}
+
+	fclose(f);
+	data = buffer;
+	size = (uint32_t)length;
+
+	return true;
+}
+#endif
+
+static bool load_index(void)
+{
+	const assets_header_t *header  = (const assets_header_t *)data;
+	const assets_entry_t  *entries = (const assets_entry_t *)(data + sizeof(assets_header_t));
+
+	if (memcmp(header->magic, ASSETS_MAGIC, sizeof(header->magic)) != 0 ||
+		header->version != ASSETS_VERSION ||
+		header->size != size ||
+		header->assets_count > ASSETS_MAX ||
+		sizeof(assets_header_t) + (header->assets_count * sizeof(assets_entry_t)) > size)
+	{
+		return false;
+	}
+
+	for (uint32_t i = 0; i < header->assets_count; i++)
+	{
+		const assets_entry_t *entry = &entries[i];
+		const asset_line_t	 *lines = (const asset_line_t *)(data + entry->lines_offset);
+
+		if (entry->name[ASSETS_NAME_SIZE - 1] != '\0' ||
+			entry->lines_offset % sizeof(uint32_t) != 0 ||
+			(uint64_t)entry->lines_offset + ((uint64_t)entry->lines_count * sizeof(asset_line_t)) > size)
+		{
+			return false;
+		}
+
+		for (uint32_t line = 0; line < entry->lines_count; line++)
+		{
+			if ((uint64_t)lines[line].offset + lines[line].length > size)
+			{
+				return false;
+			}
+		}
+
+		assets[i] = (asset_t){ .name = entry->name, .data = data, .lines = lines, .lines_count = entry->lines_count, .width = entry->width };
+	}
+
+	assets_count = header->assets_count;
+
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+#ifndef ASSETS_H
+#define ASSETS_H
+
+#include "types.h"
+
+// packed assets file (built by src/pack from src/assets/*.txt), mapped as is.
+// header, one entry per asset, the lines table of every asset and then the
+// text of the lines, without line breaks. Offsets are from the file start
+#define ASSETS_MAGIC "TPAK"
+#define ASSETS_VERSION 1
+#define ASSETS_NAME_SIZE 32
+#define ASSETS_MAX 16
+
+typedef struct assets_header_t
+{
+	char	 magic[4];
+	uint32_t version;
+	uint32_t assets_count;
+	uint32_t size; // whole file
+} assets_header_t;
+
+typedef struct assets_entry_t
+{
+	char	 name[ASSETS_NAME_SIZE]; // file name without extension
+	uint32_t lines_offset;			 // of its asset_line_t table
+	uint32_t lines_count;
+	uint32_t width; // longest line
+} assets_entry_t;
+
+typedef struct asset_line_t
+{
+	uint32_t offset;
+	uint32_t length;
+} asset_line_t;
+
+// an asset of the mapped file, lines point into it (no copies)
+typedef struct asset_t
+{
+	const char		   *name;
+	const char		   *data; // file start, line offsets are from here
+	const asset_line_t *lines;
+	uint32_t			lines_count;
+	uint32_t			width;
+} asset_t;
+
+bool		   assets_open(const char *file);
+void		   assets_close(void);
+const asset_t *assets_get(const char *name);
+const char	  *asset_get_line(const asset_t *asset, uint32_t index, uint32_t *length);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,659 @@
+#define _POSIX_C_SOURCE 200809L
+#include "broadcast.h"
+#include "data_structures/memory.h"
+#include <errno.h>
+#include <pthread.h>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#define BROADCAST_PATH_SIZE 108 // sockaddr_un's
+#define BROADCAST_ERROR_SIZE (BROADCAST_PATH_SIZE + 128)
+#define BROADCAST_KEYFRAME_INTERVAL 100 // frames, what a watcher that connects replays at most
+#define BROADCAST_SEND_CHUNK_SIZE (64 * 1024) // copied out of the ring for a send
+
+typedef struct watcher_t
+{
+	int		 fd;
+	uint64_t offset;	  // of the ring, next byte to be sent
+	uint64_t message_end; // of the message being sent, the offset between messages
+} watcher_t;
+
+// shared with the sender thread, under lock. Offsets count every byte ever
+// written, the ring holds the last BROADCAST_RING_SIZE of them
+static struct
+{
+	pthread_t		thread;
+	pthread_mutex_t lock;
+	uint8_t		   *bytes;
+	uint64_t		head;
+	uint64_t		keyframe; // offset of the last one
+	bool			keyframe_written;
+	uint32_t		watchers_count;
+	bool			quit;
+} ring;
+
+// last published panels, encoded, and the message being built. Only the
+// thread that publishes uses them
+static struct
+{
+	uint16_t	   *panels[BROADCAST_PANEL_COUNT];
+	uint16_t		rows[BROADCAST_PANEL_COUNT];
+	uint16_t		cols[BROADCAST_PANEL_COUNT];
+	broadcast_hud_t hud;
+	uint8_t		   *message;
+	uint32_t		message_size;
+	uint32_t		message_capacity;
+	uint32_t		frame;
+	uint32_t		frames_since_keyframe;
+	uint32_t		bytes_since_keyframe;
+	bool			keyframe_due;
+} publisher;
+
+// ring bytes being sent, only the sender thread uses it
+static uint8_t send_chunk[BROADCAST_SEND_CHUNK_SIZE];
+
+static char socket_path[BROADCAST_PATH_SIZE];
+static char user_name[BROADCAST_USER_SIZE];
+static char error[BROADCAST_ERROR_SIZE];
+static bool running	   = false;
+static int	listen_fd  = -1;
+static int	wake_fd[2] = { -1, -1 }; // a byte is written to wake the sender up
+
+static bool	    resize_panels(const broadcast_frame_t *frame);
+static void	    begin_message(broadcast_message_type_t type);
+static bool	    add_record(broadcast_record_type_t type, broadcast_panel_t panel, uint16_t y, uint16_t x, uint16_t count, const void *data, uint32_t size);
+static bool	    write_keyframe(const broadcast_frame_t *frame);
+static bool	    write_delta(const broadcast_frame_t *frame);
+static void	    push_message(bool keyframe);
+static void	    free_panels(void);
+#ifdef __linux__
+static bool	    open_socket(const char *path);
+static bool	    is_listening(const struct sockaddr_un *address);
+static void	   *run_sender(void *arg);
+static bool	    accept_watcher(watcher_t *watcher);
+static bool	    send_to_watcher(watcher_t *watcher);
+static uint32_t get_message_size(uint64_t chunk_offset, uint64_t start);
+#endif
+
+// listens on path, a stale socket file left there is replaced
+bool broadcast_init(const char *path, const char *user)
+{
+#ifdef __linux__
+	memset(&ring, 0, sizeof(ring));
+	memset(&publisher, 0, sizeof(publisher));
+	snprintf(user_name, sizeof(user_name), "%s", user);
+
+	if (!open_socket(path))
+	{
+		return false;
+	}
+
+	ring.bytes = (uint8_t *)memory_alloc(BROADCAST_RING_SIZE);
+	ASSERT(ring.bytes);
+
+	if (pthread_mutex_init(&ring.lock, NULL) != 0 || pthread_create(&ring.thread, NULL, run_sender, NULL) != 0)
+	{
+		snprintf(error, sizeof(error), "can't start the sender thread");
+		broadcast_dispose();
+		return false;
+	}
+
+	running = true;
+
+	return true;
+#else
+	(void)path;
+	(void)user;
+	snprintf(error, sizeof(error), "spectator mode isn't supported on this platform");
+
+	return false;
+#endif
+}
+
+// watchers see the connection closed
+void broadcast_dispose(void)
+{
+#ifdef __linux__
+	if (running)
+	{
+		pthread_mutex_lock(&ring.lock);
+		ring.quit = true;
+		pthread_mutex_unlock(&ring.lock);
+
+		write(wake_fd[1], "", 1);
+		pthread_join(ring.thread, NULL);
+		pthread_mutex_destroy(&ring.lock);
+		running = false;
+	}
+
+	if (listen_fd >= 0)
+	{
+		close(listen_fd);
+		unlink(socket_path);
+		listen_fd = -1;
+	}
+
+	for (uint8_t i = 0; i < 2; i++)
+	{
+		if (wake_fd[i] >= 0)
+		{
+			close(wake_fd[i]);
+			wake_fd[i] = -1;
+		}
+	}
+
+	memory_free(ring.bytes);
+	ring.bytes = NULL;
+	free_panels();
+#endif
+}
+
+bool broadcast_is_running(void)
+{
+	return running;
+}
+
+// what changed since the last frame, nothing when it's the same. The user
+// name of the hud is filled here
+void broadcast_publish(broadcast_frame_t *frame)
+{
+	if (!running)
+	{
+		return;
+	}
+
+	memcpy(frame->hud.user, user_name, sizeof(frame->hud.user));
+	publisher.frame++;
+	publisher.frames_since_keyframe++;
+
+	if (!resize_panels(frame))
+	{
+		return;
+	}
+
+	if (!publisher.keyframe_due && publisher.frames_since_keyframe < BROADCAST_KEYFRAME_INTERVAL)
+	{
+		// a delta bigger than a keyframe is sent as one, and so is the one
+		// that would push the last keyframe out of the ring
+		bool written = write_delta(frame) && publisher.bytes_since_keyframe + publisher.message_size <= BROADCAST_RING_SIZE / 2;
+
+		if (written)
+		{
+			if (publisher.message_size > sizeof(broadcast_message_header_t))
+			{
+				publisher.bytes_since_keyframe += publisher.message_size;
+				push_message(false);
+			}
+
+			return;
+		}
+	}
+
+	if (write_keyframe(frame))
+	{
+		publisher.bytes_since_keyframe = 0;
+		push_message(true);
+	}
+}
+
+// e.g. a new game, the next frame is a keyframe
+void broadcast_reset(void)
+{
+	publisher.keyframe_due = true;
+}
+
+const char *broadcast_get_error(void)
+{
+	return error;
+}
+
+// panels are (re)allocated when their size changes, along with the message
+// buffer, which fits a keyframe. Never while the size stays the same
+static bool resize_panels(const broadcast_frame_t *frame)
+{
+	uint32_t capacity = sizeof(broadcast_message_header_t) + sizeof(broadcast_record_header_t) + sizeof(broadcast_hud_t);
+	bool	 resized  = false;
+
+	for (uint8_t i = 0; i < BROADCAST_PANEL_COUNT; i++)
+	{
+		const broadcast_panel_cells_t *panel = &frame->panels[i];
+
+		resized |= !publisher.panels[i] || publisher.rows[i] != panel->rows || publisher.cols[i] != panel->cols;
+		capacity += sizeof(broadcast_record_header_t) + (panel->rows * (sizeof(broadcast_record_header_t) + (panel->cols * sizeof(uint16_t))));
+	}
+
+	if (!resized)
+	{
+		return true;
+	}
+
+	free_panels();
+
+	// the last keyframe has to stay in the ring while deltas are written
+	if (capacity > BROADCAST_RING_SIZE / 4)
+	{
+		return false;
+	}
+
+	for (uint8_t i = 0; i < BROADCAST_PANEL_COUNT; i++)
+	{
+		publisher.rows[i]	= frame->panels[i].rows;
+		publisher.cols[i]	= frame->panels[i].cols;
+		publisher.panels[i] = (uint16_t *)memory_alloc(publisher.rows[i] * publisher.cols[i] * sizeof(uint16_t));
+		ASSERT(publisher.panels[i]);
+	}
+
+	publisher.message		   = (uint8_t *)memory_alloc(capacity);
+	publisher.message_capacity = capacity;
+	publisher.keyframe_due	   = true;
+	ASSERT(publisher.message);
+
+	return true;
+}
+
+static void begin_message(broadcast_message_type_t type)
+{
+	broadcast_message_header_t header = { .version = BROADCAST_VERSION, .type = type, .frame = publisher.frame };
+
+	memcpy(header.magic, BROADCAST_MAGIC, sizeof(header.magic));
+	memcpy(publisher.message, &header, sizeof(header));
+	publisher.message_size = sizeof(header);
+}
+
+// false when the message is full
+static bool add_record(broadcast_record_type_t type, broadcast_panel_t panel, uint16_t y, uint16_t x, uint16_t count, const void *data, uint32_t size)
+{
+	broadcast_record_header_t header = { .type = type, .panel = panel, .y = y, .x = x, .count = count };
+
+	if (publisher.message_size + sizeof(header) + size > publisher.message_capacity)
+	{
+		return false;
+	}
+
+	memcpy(&publisher.message[publisher.message_size], &header, sizeof(header));
+	if (size > 0)
+	{
+		memcpy(&publisher.message[publisher.message_size + sizeof(header)], data, size);
+	}
+
+	publisher.message_size += sizeof(header) + size;
+
+	return true;
+}
+
+// every row of the panels as a single run, and the hud
+static bool write_keyframe(const broadcast_frame_t *frame)
+{
+	begin_message(BROADCAST_MESSAGE_KEYFRAME);
+	publisher.hud = frame->hud;
+
+	if (!add_record(BROADCAST_RECORD_HUD, 0, 0, 0, sizeof(publisher.hud), &publisher.hud, sizeof(publisher.hud)))
+	{
+		return false;
+	}
+
+	for (uint8_t i = 0; i < BROADCAST_PANEL_COUNT; i++)
+	{
+		uint16_t *cells = publisher.panels[i];
+		uint16_t  cols	= publisher.cols[i];
+
+		if (!add_record(BROADCAST_RECORD_SIZE, i, publisher.rows[i], cols, 0, NULL, 0))
+		{
+			return false;
+		}
+
+		for (uint32_t j = 0; j < (uint32_t)(publisher.rows[i] * cols); j++)
+		{
+			cells[j] = broadcast_encode_cell(frame->panels[i].cells[j]);
+		}
+
+		for (uint16_t y = 0; y < publisher.rows[i]; y++)
+		{
+			if (!add_record(BROADCAST_RECORD_CELLS, i, y, 0, cols, &cells[cols * y], cols * sizeof(uint16_t)))
+			{
+				return false;
+			}
+		}
+	}
+
+	publisher.keyframe_due			= false;
+	publisher.frames_since_keyframe = 0;
+
+	return true;
+}
+
+// runs of consecutive changed cells, and the hud when it changed. False when
+// it doesn't fit, the panels are left half updated then
+static bool write_delta(const broadcast_frame_t *frame)
+{
+	begin_message(BROADCAST_MESSAGE_DELTA);
+
+	if (memcmp(&publisher.hud, &frame->hud, sizeof(publisher.hud)) != 0)
+	{
+		publisher.hud = frame->hud;
+
+		if (!add_record(BROADCAST_RECORD_HUD, 0, 0, 0, sizeof(publisher.hud), &publisher.hud, sizeof(publisher.hud)))
+		{
+			return false;
+		}
+	}
+
+	for (uint8_t i = 0; i < BROADCAST_PANEL_COUNT; i++)
+	{
+		uint16_t cols = publisher.cols[i];
+
+		for (uint16_t y = 0; y < publisher.rows[i]; y++)
+		{
+			uint16_t	 *row	= &publisher.panels[i][cols * y];
+			const chtype *cells = &frame->panels[i].cells[cols * y];
+
+			for (uint16_t x = 0; x < cols; x++)
+			{
+				uint16_t start = x;
+
+				while (x < cols && row[x] != broadcast_encode_cell(cells[x]))
+				{
+					row[x] = broadcast_encode_cell(cells[x]);
+					x++;
+				}
+
+				if (x > start && !add_record(BROADCAST_RECORD_CELLS, i, y, start, x - start, &row[start], (x - start) * sizeof(uint16_t)))
+				{
+					return false;
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+// into the ring, the oldest bytes are overwritten. Watchers are waiting for
+// it only when there's any
+static void push_message(bool keyframe)
+{
+	broadcast_message_header_t *header = (broadcast_message_header_t *)publisher.message;
+
+	header->size = publisher.message_size - sizeof(broadcast_message_header_t);
+
+	pthread_mutex_lock(&ring.lock);
+
+	uint32_t start = ring.head % BROADCAST_RING_SIZE;
+	uint32_t first = BROADCAST_RING_SIZE - start < publisher.message_size ? BROADCAST_RING_SIZE - start : publisher.message_size;
+
+	memcpy(&ring.bytes[start], publisher.message, first);
+	memcpy(ring.bytes, &publisher.message[first], publisher.message_size - first);
+
+	if (keyframe)
+	{
+		ring.keyframe		  = ring.head;
+		ring.keyframe_written = true;
+	}
+
+	ring.head += publisher.message_size;
+	bool wake = ring.watchers_count > 0;
+	pthread_mutex_unlock(&ring.lock);
+
+#ifdef __linux__
+	if (wake)
+	{
+		write(wake_fd[1], "", 1);
+	}
+#else
+	(void)wake;
+#endif
+}
+
+static void free_panels(void)
+{
+	for (uint8_t i = 0; i < BROADCAST_PANEL_COUNT; i++)
+	{
+		memory_free(publisher.panels[i]);
+		publisher.panels[i] = NULL;
+	}
+
+	memory_free(publisher.message);
+	publisher.message		   = NULL;
+	publisher.message_capacity = 0;
+}
+
+#ifdef __linux__
+static bool open_socket(const char *path)
+{
+	struct sockaddr_un address = { .sun_family = AF_UNIX };
+
+	if (snprintf(socket_path, sizeof(socket_path), "%s", path) >= (int)sizeof(socket_path))
+	{
+		snprintf(error, sizeof(error), "%s: socket path too long", path);
+		return false;
+	}
+
+	memcpy(address.sun_path, socket_path, sizeof(address.sun_path));
+	listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+
+	if (listen_fd < 0)
+	{
+		snprintf(error, sizeof(error), "can't create a socket: %s", strerror(errno));
+		return false;
+	}
+
+	bool bound = bind(listen_fd, (struct sockaddr *)&address, sizeof(address)) == 0;
+
+	// left by a game that crashed, nobody is listening there
+	if (!bound && errno == EADDRINUSE && !is_listening(&address))
+	{
+		unlink(socket_path);
+		bound = bind(listen_fd, (struct sockaddr *)&address, sizeof(address)) == 0;
+	}
+
+	if (!bound || listen(listen_fd, BROADCAST_WATCHERS_MAX) != 0)
+	{
+		snprintf(error, sizeof(error), "can't listen on %s: %s", socket_path, strerror(errno));
+		close(listen_fd);
+		listen_fd = -1;
+		return false;
+	}
+
+	if (pipe(wake_fd) != 0)
+	{
+		snprintf(error, sizeof(error), "can't create a pipe: %s", strerror(errno));
+		broadcast_dispose();
+		return false;
+	}
+
+	fcntl(listen_fd, F_SETFL, O_NONBLOCK);
+	fcntl(wake_fd[0], F_SETFL, O_NONBLOCK);
+	fcntl(wake_fd[1], F_SETFL, O_NONBLOCK);
+
+	return true;
+}
+
+static bool is_listening(const struct sockaddr_un *address)
+{
+	int	 fd		   = socket(AF_UNIX, SOCK_STREAM, 0);
+	bool listening = fd >= 0 && connect(fd, (const struct sockaddr *)address, sizeof(*address)) == 0;
+
+	if (fd >= 0)
+	{
+		close(fd);
+	}
+
+	return listening;
+}
+
+// accepts watchers and sends them the ring from their offsets, those that
+// can't take more are waited on without holding the others back
+static void *run_sender(void *arg)
+{
+	watcher_t	  watchers[BROADCAST_WATCHERS_MAX];
+	struct pollfd fds[BROADCAST_WATCHERS_MAX + 2];
+	uint32_t	  watchers_count = 0;
+	char		  wake_bytes[64];
+
+	(void)arg;
+
+	while (true)
+	{
+		pthread_mutex_lock(&ring.lock);
+		bool	 quit = ring.quit;
+		uint64_t head = ring.head;
+		pthread_mutex_unlock(&ring.lock);
+
+		if (quit)
+		{
+			break;
+		}
+
+		fds[0] = (struct pollfd) { .fd = wake_fd[0], .events = POLLIN };
+		fds[1] = (struct pollfd) { .fd = listen_fd, .events = watchers_count < BROADCAST_WATCHERS_MAX ? POLLIN : 0 };
+
+		// hang ups are reported without asking
+		for (uint32_t i = 0; i < watchers_count; i++)
+		{
+			fds[i + 2] = (struct pollfd) { .fd = watchers[i].fd, .events = watchers[i].offset < head ? POLLOUT : 0 };
+		}
+
+		if (poll(fds, watchers_count + 2, -1) < 0)
+		{
+			continue;
+		}
+
+		while (read(wake_fd[0], wake_bytes, sizeof(wake_bytes)) > 0)
+		{
+		}
+
+		// backwards, a dropped watcher is replaced by the last one
+		for (uint32_t i = watchers_count; i-- > 0;)
+		{
+			bool dropped = (fds[i + 2].revents & (POLLERR | POLLHUP | POLLNVAL)) ||
+						   ((fds[i + 2].revents & POLLOUT) && !send_to_watcher(&watchers[i]));
+
+			if (dropped)
+			{
+				close(watchers[i].fd);
+				watchers[i] = watchers[--watchers_count];
+
+				pthread_mutex_lock(&ring.lock);
+				ring.watchers_count--;
+				pthread_mutex_unlock(&ring.lock);
+			}
+		}
+
+		if ((fds[1].revents & POLLIN) && accept_watcher(&watchers[watchers_count]))
+		{
+			watchers_count++;
+		}
+	}
+
+	for (uint32_t i = 0; i < watchers_count; i++)
+	{
+		close(watchers[i].fd);
+	}
+
+	return NULL;
+}
+
+// from the last keyframe, or from the next one when there's none yet
+static bool accept_watcher(watcher_t *watcher)
+{
+	int fd = accept(listen_fd, NULL, NULL);
+
+	if (fd < 0)
+	{
+		return false;
+	}
+
+	fcntl(fd, F_SETFL, O_NONBLOCK);
+
+	pthread_mutex_lock(&ring.lock);
+	watcher->fd			 = fd;
+	watcher->offset		 = ring.keyframe_written ? ring.keyframe : ring.head;
+	watcher->message_end = watcher->offset;
+	ring.watchers_count++;
+	pthread_mutex_unlock(&ring.lock);
+
+	return true;
+}
+
+// as much as the socket takes, up to BROADCAST_SEND_CHUNK_SIZE. The bytes are
+// copied out of the ring under its lock and sent from send_chunk, the ring
+// can be written meanwhile. False when the watcher has to be dropped
+static bool send_to_watcher(watcher_t *watcher)
+{
+	pthread_mutex_lock(&ring.lock);
+
+	uint64_t head = ring.head;
+	uint64_t tail = head > BROADCAST_RING_SIZE ? head - BROADCAST_RING_SIZE : 0;
+
+	// too slow, skipped to the last keyframe (always in the ring) unless in
+	// the middle of a message
+	if (watcher->offset < tail && watcher->offset != watcher->message_end)
+	{
+		pthread_mutex_unlock(&ring.lock);
+		return false;
+	}
+
+	if (watcher->offset < tail)
+	{
+		watcher->offset		 = ring.keyframe;
+		watcher->message_end = ring.keyframe;
+	}
+
+	uint64_t offset = watcher->offset;
+	uint32_t start	= offset % BROADCAST_RING_SIZE;
+	uint32_t size	= head - offset < BROADCAST_SEND_CHUNK_SIZE ? head - offset : BROADCAST_SEND_CHUNK_SIZE;
+	uint32_t first	= BROADCAST_RING_SIZE - start < size ? BROADCAST_RING_SIZE - start : size;
+
+	memcpy(send_chunk, &ring.bytes[start], first);
+	memcpy(&send_chunk[first], ring.bytes, size - first);
+	pthread_mutex_unlock(&ring.lock);
+
+	// whole messages only, unless the first one doesn't fit, so a watcher
+	// that keeps up stops between messages. The header of every message
+	// started in the chunk is in it
+	uint64_t whole_end = watcher->message_end;
+
+	while (whole_end + sizeof(broadcast_message_header_t) <= offset + size && whole_end + get_message_size(offset, whole_end) <= offset + size)
+	{
+		whole_end += get_message_size(offset, whole_end);
+	}
+
+	if (whole_end > offset && whole_end <= offset + size)
+	{
+		size = (uint32_t)(whole_end - offset);
+	}
+
+	ssize_t sent = send(watcher->fd, send_chunk, size, MSG_NOSIGNAL | MSG_DONTWAIT);
+
+	if (sent < 0)
+	{
+		return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+	}
+
+	watcher->offset += sent;
+
+	while (watcher->message_end < watcher->offset)
+	{
+		watcher->message_end += get_message_size(offset, watcher->message_end);
+	}
+
+	return true;
+}
+
+// header and records of the message at start, which is in send_chunk
+// (copied from chunk_offset)
+static uint32_t get_message_size(uint64_t chunk_offset, uint64_t start)
+{
+	broadcast_message_header_t header;
+
+	memcpy(&header, &send_chunk[start - chunk_offset], sizeof(header));
+
+	return sizeof(header) + header.size;
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,107 @@
+#ifndef BROADCAST_H
+#define BROADCAST_H
+
+#include "defs.h"
+
+// live games for spectators (tetris --watch, see watch.h), on a unix domain
+// socket.
+//
+// The stage publishes its panels every frame. Only what changed since the
+// previous one goes out (a delta), but every now and then the whole of it (a
+// keyframe), which is where watchers that connect start from. Messages are
+// appended to a ring buffer shared by every watcher, each one at its own
+// offset, sent by a thread of its own: publishing is a copy into the ring,
+// never a wait on a watcher. One too slow to keep up with the ring skips to
+// the last keyframe
+#define BROADCAST_MAGIC "TBCS"
+#define BROADCAST_VERSION 1
+#define BROADCAST_RING_SIZE (256 * 1024)
+#define BROADCAST_WATCHERS_MAX 32
+#define BROADCAST_USER_SIZE 16
+
+typedef enum broadcast_message_type_t
+{
+	BROADCAST_MESSAGE_KEYFRAME = 1,
+	BROADCAST_MESSAGE_DELTA	   = 2
+} broadcast_message_type_t;
+
+typedef enum broadcast_panel_t
+{
+	BROADCAST_PANEL_BOARD	   = 0, // shapes are drawn on it, the falling one too
+	BROADCAST_PANEL_NEXT_SHAPE = 1,
+	BROADCAST_PANEL_COUNT	   = 2
+} broadcast_panel_t;
+
+typedef enum broadcast_record_type_t
+{
+	BROADCAST_RECORD_SIZE  = 1, // a panel's rows (y) and cols (x), keyframes only
+	BROADCAST_RECORD_CELLS = 2, // count cells of a row, from y, x
+	BROADCAST_RECORD_HUD   = 3	// count bytes, a broadcast_hud_t
+} broadcast_record_type_t;
+
+// messages are a header followed by records, each one a record header and
+// its data. Values are in host order, both ends are on the same host
+typedef struct broadcast_message_header_t
+{
+	char	 magic[4];
+	uint8_t	 version;
+	uint8_t	 type;
+	uint16_t reserved;
+	uint32_t frame; // since the publisher started
+	uint32_t size;	// of the records
+} broadcast_message_header_t;
+
+typedef struct broadcast_record_header_t
+{
+	uint8_t	 type;
+	uint8_t	 panel;
+	uint16_t y;
+	uint16_t x;
+	uint16_t count;
+} broadcast_record_header_t;
+
+// the score panel
+typedef struct broadcast_hud_t
+{
+	char	 user[BROADCAST_USER_SIZE]; // null terminated
+	uint16_t score;
+	uint16_t record;
+	uint8_t	 level;
+	bool	 game_over;
+	bool	 paused;
+	uint8_t	 reserved;
+} broadcast_hud_t;
+
+// a panel as drawn, rows * cols
+typedef struct broadcast_panel_cells_t
+{
+	const chtype *cells;
+	uint16_t	  rows;
+	uint16_t	  cols;
+} broadcast_panel_cells_t;
+
+typedef struct broadcast_frame_t
+{
+	broadcast_panel_cells_t panels[BROADCAST_PANEL_COUNT];
+	broadcast_hud_t			hud;
+} broadcast_frame_t;
+
+bool		broadcast_init(const char *path, const char *user);
+void		broadcast_dispose(void);
+bool		broadcast_is_running(void);
+void		broadcast_publish(broadcast_frame_t *frame);
+void		broadcast_reset(void);
+const char *broadcast_get_error(void);
+
+// cells on the wire: the character, A_ALTCHARSET and the color pair
+static inline uint16_t broadcast_encode_cell(chtype cell)
+{
+	return (cell & 0x7f) | ((cell & A_ALTCHARSET) ? 0x80 : 0) | (PAIR_NUMBER(cell) << 8);
+}
+
+static inline chtype broadcast_decode_cell(uint16_t cell)
+{
+	return (cell & 0x7f) | ((cell & 0x80) ? A_ALTCHARSET : 0) | COLOR_PAIR(cell >> 8);
+}
+
+#endif
\ No newline at end of file
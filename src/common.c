@@ -18,12 +18,3 @@ void error_handler(const char *file, const char *function, int line, const char
 
 	exit(1);
 }
-
-void set_offset_yx(uint8_t height, uint8_t width, uint8_t *offset_y, uint8_t *offset_x)
-{
-	uint8_t rows, cols;
-	getmaxyx(stdscr, rows, cols);
-
-	*offset_y = (rows - height) * 0.5;
-	*offset_x = (cols - width) * 0.5;
-}
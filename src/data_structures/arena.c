@@ -0,0 +1,154 @@
+#include "arena.h"
+
+#define ARENA_BLOCK_HEADER_SIZE ((sizeof(arena_block_t) + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1))
+
+static size_t		  align_size(size_t size);
+static uint8_t		 *get_block_data(arena_block_t *block);
+static arena_block_t *new_block(size_t size);
+
+arena_t arena_new(size_t block_size)
+{
+	arena_t arena;
+
+	memset(&arena, 0, sizeof(arena_t));
+	arena.block_size = block_size;
+
+	return arena;
+}
+
+void arena_dispose(arena_t *arena)
+{
+	arena_block_t *block = arena->blocks;
+
+	while (block)
+	{
+		arena_block_t *next = block->next;
+		memory_free(block);
+		block = next;
+	}
+
+	memset(arena, 0, sizeof(arena_t));
+}
+
+// zeroed memory, ARENA_ALIGNMENT aligned
+void *arena_alloc(arena_t *arena, size_t size)
+{
+	arena_block_t *block = arena->current;
+
+	size = align_size(size);
+
+	// blocks kept by arena_reset are tried before new ones
+	while (block && block->used + size > block->size)
+	{
+		block = block->next;
+	}
+
+	// linked right after the current block, the ones after it are still free
+	if (!block && arena->current)
+	{
+		block				 = new_block(size > arena->block_size ? size : arena->block_size);
+		block->next			 = arena->current->next;
+		arena->current->next = block;
+	}
+	else if (!block)
+	{
+		block		  = new_block(size > arena->block_size ? size : arena->block_size);
+		arena->blocks = block;
+	}
+
+	uint8_t *result = get_block_data(block) + block->used;
+
+	block->used += size;
+	arena->current = block;
+	arena->last	   = result;
+	memset(result, 0, size);
+
+	return result;
+}
+
+// grows in place when ptr is the latest allocation and the block has room,
+// otherwise it's copied to a new allocation (the old one is lost until reset)
+void *arena_realloc(arena_t *arena, void *ptr, size_t old_size, size_t size)
+{
+	arena_block_t *block = arena->current;
+
+	if (!ptr)
+	{
+		return arena_alloc(arena, size);
+	}
+
+	if (ptr == arena->last && block && (uint8_t *)ptr + align_size(size) <= get_block_data(block) + block->size)
+	{
+		block->used = ((uint8_t *)ptr - get_block_data(block)) + align_size(size);
+
+		if (size > old_size)
+		{
+			memset((uint8_t *)ptr + old_size, 0, size - old_size);
+		}
+
+		return ptr;
+	}
+
+	void *result = arena_alloc(arena, size);
+	memcpy(result, ptr, old_size < size ? old_size : size);
+
+	return result;
+}
+
+void arena_reset(arena_t *arena)
+{
+	for (arena_block_t *block = arena->blocks; block; block = block->next)
+	{
+		block->used = 0;
+	}
+
+	arena->current = arena->blocks;
+	arena->last	   = NULL;
+}
+
+size_t arena_get_used(const arena_t *arena)
+{
+	size_t used = 0;
+
+	for (const arena_block_t *block = arena->blocks; block; block = block->next)
+	{
+		used += block->used;
+	}
+
+	return used;
+}
+
+size_t arena_get_capacity(const arena_t *arena)
+{
+	size_t capacity = 0;
+
+	for (const arena_block_t *block = arena->blocks; block; block = block->next)
+	{
+		capacity += block->size;
+	}
+
+	return capacity;
+}
+
+static size_t align_size(size_t size)
+{
+	return (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+}
+
+static uint8_t *get_block_data(arena_block_t *block)
+{
+	return (uint8_t *)block + ARENA_BLOCK_HEADER_SIZE;
+}
+
+static arena_block_t *new_block(size_t size)
+{
+	arena_block_t *block = (arena_block_t *)memory_alloc(ARENA_BLOCK_HEADER_SIZE + size);
+
+	ASSERT(block);
+
+	block->next = NULL;
+	block->size = size;
+	block->used = 0;
+
+	return block;
+}
\ No newline at end of file
@@ -0,0 +1,37 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include "../common.h"
+#include "../types.h"
+#include "memory.h"
+
+#define ARENA_ALIGNMENT 16
+
+typedef struct arena_block_t
+{
+	struct arena_block_t *next;
+	size_t				  size;
+	size_t				  used;
+} arena_block_t;
+
+// bump allocator for memory with the same lifetime (e.g. a screen, from
+// init to dispose). Nothing is freed on its own: arena_reset makes all of
+// it available again, keeping the blocks, so a lifetime that needs the same
+// memory as the previous one doesn't touch the heap
+typedef struct arena_t
+{
+	arena_block_t *blocks;
+	arena_block_t *current;
+	size_t		   block_size;
+	void		  *last; // latest allocation, the only one that can grow in place
+} arena_t;
+
+arena_t arena_new(size_t block_size);
+void	arena_dispose(arena_t *arena);
+void   *arena_alloc(arena_t *arena, size_t size);
+void   *arena_realloc(arena_t *arena, void *ptr, size_t old_size, size_t size);
+void	arena_reset(arena_t *arena);
+size_t	arena_get_used(const arena_t *arena);
+size_t	arena_get_capacity(const arena_t *arena);
+
+#endif
\ No newline at end of file
@@ -1,7 +1,11 @@
 #ifndef DATA_STRUCTURES_H
 #define DATA_STRUCTURES_H
 
+#include "arena.h"
+#include "fixed_sparse_set.h"
+#include "memory.h"
 #include "sparse_set.h"
+#include "spsc_queue.h"
 #include "vector.h"
 
 #endif
\ No newline at end of file
@@ -0,0 +1,96 @@
+#ifndef FIXED_SPARSE_SET_H
+#define FIXED_SPARSE_SET_H
+
+#include "../common.h"
+#include "../types.h"
+
+// sparse set of ids in [0, capacity) with inline storage, capacity fixed at
+// compile time, so it never allocates and can be copied with its owner.
+// An id is in the set when its stamp is the current generation, so clearing
+// is a generation increment (stamps are only reset when it wraps around).
+// Declare a type per capacity: typedef FIXED_SPARSE_SET_T(20) rows_set_t;
+#define FIXED_SPARSE_SET_T(capacity) \
+	struct                           \
+	{                                \
+		uint32_t generation;         \
+		uint32_t length;             \
+		uint32_t stamps[capacity];   \
+		uint16_t sparse[capacity];   \
+		uint16_t dense[capacity];    \
+	}
+
+#define FIXED_SPARSE_SET_CAPACITY(set) ((uint32_t)(sizeof((set).dense) / sizeof((set).dense[0])))
+#define FIXED_SPARSE_SET_LENGTH(set) ((set).length)
+#define FIXED_SPARSE_SET_GET(set, index) ((set).dense[index]) // iteration, index < length
+
+// unchecked, ids have to be below the capacity
+#define FIXED_SPARSE_SET_CONTAINS(set, id) ((set).stamps[id] == (set).generation)
+
+#define FIXED_SPARSE_SET_INIT(set)                     \
+	do                                                 \
+	{                                                  \
+		memset((set).stamps, 0, sizeof((set).stamps)); \
+		(set).generation = 1;                          \
+		(set).length = 0;                              \
+	} while (0)
+
+#define FIXED_SPARSE_SET_ADD(set, id)                    \
+	do                                                   \
+	{                                                    \
+		uint32_t _id = (id);                             \
+		ASSERT(_id < FIXED_SPARSE_SET_CAPACITY(set));    \
+		if (!FIXED_SPARSE_SET_CONTAINS(set, _id))        \
+		{                                                \
+			(set).stamps[_id] = (set).generation;        \
+			(set).sparse[_id] = (uint16_t)(set).length;  \
+			(set).dense[(set).length++] = (uint16_t)_id; \
+		}                                                \
+	} while (0)
+
+#define FIXED_SPARSE_SET_ADD_ALL(set, ids, count) \
+	do                                            \
+	{                                             \
+		for (uint32_t _i = 0; _i < (count); _i++) \
+		{                                         \
+			FIXED_SPARSE_SET_ADD(set, (ids)[_i]); \
+		}                                         \
+	} while (0)
+
+// the last id takes the place of the removed one
+#define FIXED_SPARSE_SET_REMOVE(set, id)                  \
+	do                                                    \
+	{                                                     \
+		uint32_t _id = (id);                              \
+		if (_id < FIXED_SPARSE_SET_CAPACITY(set) &&       \
+			FIXED_SPARSE_SET_CONTAINS(set, _id))          \
+		{                                                 \
+			uint16_t _last = (set).dense[--(set).length]; \
+			(set).dense[(set).sparse[_id]] = _last;       \
+			(set).sparse[_last] = (set).sparse[_id];      \
+			(set).stamps[_id] = 0;                        \
+		}                                                 \
+	} while (0)
+
+// the same set in another one of the same type, when all its ids are below
+// ids_count only the first ids_count stamps are copied
+#define FIXED_SPARSE_SET_COPY(dest, source, ids_count)                                     \
+	do                                                                                     \
+	{                                                                                      \
+		(dest).generation = (source).generation;                                           \
+		(dest).length = (source).length;                                                   \
+		memcpy((dest).stamps, (source).stamps, sizeof((source).stamps[0]) * (ids_count));  \
+		memcpy((dest).sparse, (source).sparse, sizeof((source).sparse[0]) * (ids_count));  \
+		memcpy((dest).dense, (source).dense, sizeof((source).dense[0]) * (source).length); \
+	} while (0)
+
+#define FIXED_SPARSE_SET_CLEAR(set)     \
+	do                                  \
+	{                                   \
+		(set).length = 0;               \
+		if (++(set).generation == 0)    \
+		{                               \
+			FIXED_SPARSE_SET_INIT(set); \
+		}                               \
+	} while (0)
+
+#endif
\ No newline at end of file
@@ -0,0 +1,36 @@
+#include "memory.h"
+
+// shared by every thread (e.g. the simulator workers)
+static uint64_t allocations;
+
+void *memory_alloc(size_t size)
+{
+	__atomic_add_fetch(&allocations, 1, __ATOMIC_RELAXED);
+
+	return malloc(size);
+}
+
+void *memory_calloc(size_t count, size_t size)
+{
+	__atomic_add_fetch(&allocations, 1, __ATOMIC_RELAXED);
+
+	return calloc(count, size);
+}
+
+void *memory_realloc(void *ptr, size_t size)
+{
+	__atomic_add_fetch(&allocations, 1, __ATOMIC_RELAXED);
+
+	return realloc(ptr, size);
+}
+
+void memory_free(void *ptr)
+{
+	free(ptr);
+}
+
+// calls to alloc, calloc and realloc so far
+uint64_t memory_get_allocations(void)
+{
+	return __atomic_load_n(&allocations, __ATOMIC_RELAXED);
+}
\ No newline at end of file
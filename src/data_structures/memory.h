@@ -0,0 +1,15 @@
+#ifndef MEMORY_H
+#define MEMORY_H
+
+#include "../common.h"
+#include "../types.h"
+
+// heap allocations of the game go through these, so they can be counted
+// (e.g. none should happen while a stage is running). Curses' own aren't
+void	*memory_alloc(size_t size);
+void	*memory_calloc(size_t count, size_t size);
+void	*memory_realloc(void *ptr, size_t size);
+void	 memory_free(void *ptr);
+uint64_t memory_get_allocations(void);
+
+#endif
\ No newline at end of file
@@ -1,23 +1,41 @@
 #include "sparse_set.h"
 
 sparse_set_t sparse_set_new(uint32_t chunk_size)
+{
+	return sparse_set_new_in(NULL, chunk_size);
+}
+
+// everything from the arena, which has to outlive the set. The dense ids
+// start with room for chunk_size of them instead of VECTOR_CHUNK_SIZE
+sparse_set_t sparse_set_new_in(arena_t *arena, uint32_t chunk_size)
 {
 	sparse_set_t sparse_set;
 
+	sparse_set.arena	   = arena;
 	sparse_set.chunk_size  = chunk_size;
 	sparse_set.dense	   = 0;
-	sparse_set.sparse	   = (uint32_t *)malloc(chunk_size * sizeof(uint32_t));
+	sparse_set.sparse	   = arena ? (uint32_t *)arena_alloc(arena, chunk_size * sizeof(uint32_t)) : (uint32_t *)memory_alloc(chunk_size * sizeof(uint32_t));
 	sparse_set.sparse_size = chunk_size;
 
 	ASSERT(sparse_set.sparse);
 
+	if (arena)
+	{
+		VECTOR_RESERVE(sparse_set.dense, arena, chunk_size);
+	}
+
 	return sparse_set;
 }
 
 void sparse_set_dispose(sparse_set_t *sparse_set)
 {
 	VECTOR_DISPOSE(sparse_set->dense);
-	free(sparse_set->sparse);
+
+	if (!sparse_set->arena)
+	{
+		memory_free(sparse_set->sparse);
+	}
+
 	sparse_set->sparse = NULL;
 }
 
@@ -33,7 +51,17 @@ void sparse_set_add(sparse_set_t *sparse_set, uint32_t id)
 		}
 
 		size_needed += sparse_set->sparse_size;
-		uint32_t *temp = (uint32_t *)realloc(sparse_set->sparse, sizeof(uint32_t) * size_needed);
+		uint32_t *temp;
+
+		if (sparse_set->arena)
+		{
+			temp = (uint32_t *)arena_realloc(sparse_set->arena, sparse_set->sparse, sizeof(uint32_t) * sparse_set->sparse_size, sizeof(uint32_t) * size_needed);
+		}
+		else
+		{
+			temp = (uint32_t *)memory_realloc(sparse_set->sparse, sizeof(uint32_t) * size_needed);
+		}
+
 
 		ASSERT(temp);
 
@@ -2,11 +2,12 @@
 #define SPARSE_SET_H
 
 #include "../common.h"
-#include "../defs.h"
+#include "../types.h"
 #include "vector.h"
 
 typedef struct
 {
+	arena_t	 *arena; // NULL for the heap
 	uint32_t  chunk_size;
 	uint32_t  sparse_size;
 	uint32_t *sparse;
@@ -23,6 +24,7 @@ typedef struct
 #define SPARSE_SET_INDEXOF(sparse_set, id) (SPARSE_SET_CONTAINS(sparse_set, id) ? (int32_t)sparse_set.sparse[id] : -1)
 
 sparse_set_t sparse_set_new(uint32_t chunk_size);
+sparse_set_t sparse_set_new_in(arena_t *arena, uint32_t chunk_size);
 void		 sparse_set_dispose(sparse_set_t *sparse_set);
 void		 sparse_set_add(sparse_set_t *sparse_set, uint32_t id);
 void		 sparse_set_remove(sparse_set_t *sparse_set, uint32_t id);
@@ -0,0 +1,51 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include "../common.h"
+#include "../types.h"
+
+#define SPSC_QUEUE_CACHE_LINE 64
+
+// lock free queue between one producer thread and one consumer thread, with
+// inline storage and the capacity (a power of two) fixed at compile time.
+// Only the producer writes tail and only the consumer writes head, each on
+// its own cache line. An item is written before tail is published (release)
+// and read after tail is loaded (acquire), so it's never seen half written.
+// Declare a type per item and capacity: typedef SPSC_QUEUE_T(uint8_t, 64) actions_queue_t;
+#define SPSC_QUEUE_T(type, capacity)                                    \
+	struct                                                              \
+	{                                                                   \
+		uint32_t head;                                                  \
+		uint8_t head_padding[SPSC_QUEUE_CACHE_LINE - sizeof(uint32_t)]; \
+		uint32_t tail;                                                  \
+		uint8_t tail_padding[SPSC_QUEUE_CACHE_LINE - sizeof(uint32_t)]; \
+		type items[capacity];                                           \
+	}
+
+#define SPSC_QUEUE_CAPACITY(queue) ((uint32_t)(sizeof((queue).items) / sizeof((queue).items[0])))
+
+// before both threads use it
+#define SPSC_QUEUE_INIT(queue) \
+	do                         \
+	{                          \
+		(queue).head = 0;      \
+		(queue).tail = 0;      \
+	} while (0)
+
+// producer side, false (and the item dropped) when the queue is full
+#define SPSC_QUEUE_PUSH(queue, item)                                                               \
+	((queue).tail - __atomic_load_n(&(queue).head, __ATOMIC_ACQUIRE) >= SPSC_QUEUE_CAPACITY(queue) \
+		 ? false                                                                                   \
+		 : ((queue).items[(queue).tail & (SPSC_QUEUE_CAPACITY(queue) - 1)] = (item),               \
+			__atomic_store_n(&(queue).tail, (queue).tail + 1, __ATOMIC_RELEASE),                   \
+			true))
+
+// consumer side, false when the queue is empty
+#define SPSC_QUEUE_POP(queue, dest)                                                   \
+	(__atomic_load_n(&(queue).tail, __ATOMIC_ACQUIRE) == (queue).head                 \
+		 ? false                                                                      \
+		 : (*(dest) = (queue).items[(queue).head & (SPSC_QUEUE_CAPACITY(queue) - 1)], \
+			__atomic_store_n(&(queue).head, (queue).head + 1, __ATOMIC_RELEASE),      \
+			true))
+
+#endif
\ No newline at end of file
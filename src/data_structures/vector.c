@@ -1,27 +1,50 @@
 #include "vector.h"
 
+// empty vector with room for size items, from the arena or the heap (NULL)
+void *vector_new(arena_t *arena, size_t type_size, size_t size)
+{
+	size_t			 bytes	= (size * type_size) + sizeof(vector_header_t);
+	vector_header_t *header = arena ? (vector_header_t *)arena_alloc(arena, bytes) : (vector_header_t *)memory_alloc(bytes);
+
+	ASSERT(header);
+
+	header->arena  = arena;
+	header->size   = size;
+	header->length = 0;
+
+	return (header + 1);
+}
+
 void *vector_realloc(void *vec, size_t type_size, size_t chunk_size)
 {
-	uint32_t  size	   = VECTOR_SIZE(vec);
-	uint32_t  length   = VECTOR_LENGTH(vec);
-	uint32_t  new_size = size == 0 ? chunk_size : size * 2;
-	uint32_t *header   = vec ? _VECTOR_HEADER(vec) : 0;
+	uint32_t		 size	  = VECTOR_SIZE(vec);
+	uint32_t		 new_size = size == 0 ? chunk_size : size * 2;
+	vector_header_t *header	  = vec ? _VECTOR_HEADER(vec) : 0;
+	vector_header_t *result;
 
-	uint32_t *result = (uint32_t *)realloc(header, (new_size * type_size) + (2 * sizeof(uint32_t)));
+	if (header && header->arena)
+	{
+		result = (vector_header_t *)arena_realloc(header->arena, header, (size * type_size) + sizeof(vector_header_t), (new_size * type_size) + sizeof(vector_header_t));
+	}
+	else
+	{
+		result = (vector_header_t *)memory_realloc(header, (new_size * type_size) + sizeof(vector_header_t));
+		ASSERT(result);
 
-	ASSERT(result);
+		result->arena  = NULL;
+		result->length = header ? result->length : 0;
+	}
 
-	result[0] = new_size;
-	result[1] = length;
+	result->size = new_size;
 
-	return (result + 2);
+	return (result + 1);
 }
 
 void vector_remove(void *vec, size_t type_size, uint32_t index)
 {
-	uint32_t  size	 = VECTOR_SIZE(vec);
-	uint32_t  length = VECTOR_LENGTH(vec);
-	uint32_t *header = vec ? _VECTOR_HEADER(vec) : 0;
+	uint32_t		 size	= VECTOR_SIZE(vec);
+	uint32_t		 length = VECTOR_LENGTH(vec);
+	vector_header_t *header = vec ? _VECTOR_HEADER(vec) : 0;
 
 	if (size == 0 || length == 0)
 	{
@@ -35,5 +58,5 @@ void vector_remove(void *vec, size_t type_size, uint32_t index)
 		memmove(vec + offset, vec + offset_last, type_size);
 	}
 
-	header[1]--;
+	header->length--;
 }
\ No newline at end of file
@@ -1,20 +1,11 @@
 #ifndef DEFS_H
 #define DEFS_H
 
+#include "types.h"
 #include <curses.h>
-#include <math.h>
-#include <stdbool.h>
-#include <stdint.h>
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
 #include <sys/time.h>
 #include <time.h>
 
-// TYPES
-typedef float  float32_t;
-typedef double float64_t;
-
 // DEFS
 #define CH_SHAPE_SOLID_FILL ACS_BLOCK
 #define CH_SHAPE_FILL ACS_CKBOARD
@@ -34,55 +25,22 @@ typedef double float64_t;
 #define CH_PAUSE_U 'P'
 #define CH_SHAPE_SHADOW_L 's'
 #define CH_SHAPE_SHADOW_U 'S'
-
-#define FILE_SCORE "score.txt"
-
-typedef enum color_pair_t
-{
-	COLOR_PAIR_RED_DEFAULT	   = 1,
-	COLOR_PAIR_BLUE_DEFAULT	   = 2,
-	COLOR_PAIR_GREEN_DEFAULT   = 3,
-	COLOR_PAIR_YELLOW_DEFAULT  = 4,
-	COLOR_PAIR_ORANGE_DEFAULT  = 5,
-	COLOR_PAIR_CYAN_DEFAULT	   = 6,
-	COLOR_PAIR_MAGENTA_DEFAULT = 7,
-	COLOR_PAIR_WHITE_DEFAULT   = 8,
-
-	COLOR_PAIR_RED_LOW	  = 10,
-	COLOR_PAIR_RED_MEDIUM = 11,
-	COLOR_PAIR_RED_HIGH	  = 12,
-
-	COLOR_PAIR_BLUE_LOW	   = 20,
-	COLOR_PAIR_BLUE_MEDIUM = 21,
-	COLOR_PAIR_BLUE_HIGH   = 22,
-
-	COLOR_PAIR_GREEN_LOW	= 30,
-	COLOR_PAIR_GREEN_MEDIUM = 31,
-	COLOR_PAIR_GREEN_HIGH	= 32,
-
-	COLOR_PAIR_YELLOW_LOW	 = 40,
-	COLOR_PAIR_YELLOW_MEDIUM = 41,
-	COLOR_PAIR_YELLOW_HIGH	 = 42,
-
-	COLOR_PAIR_ORANGE_LOW	 = 50,
-	COLOR_PAIR_ORANGE_MEDIUM = 51,
-	COLOR_PAIR_ORANGE_HIGH	 = 52,
-
-	COLOR_PAIR_CYAN_LOW	   = 60,
-	COLOR_PAIR_CYAN_MEDIUM = 61,
-	COLOR_PAIR_CYAN_HIGH   = 62,
-
-	COLOR_PAIR_MAGENTA_LOW	  = 70,
-	COLOR_PAIR_MAGENTA_MEDIUM = 71,
-	COLOR_PAIR_MAGENTA_HIGH	  = 72,
-
-	COLOR_PAIR_WHITE_LOW	= 80,
-	COLOR_PAIR_WHITE_MEDIUM = 81,
-	COLOR_PAIR_WHITE_HIGH	= 82,
-
-	COLOR_PAIR_BLUE_BK = 90,
-	COLOR_PAIR_RED_BK  = 91
-} color_pair_t;
+#define CH_BOT_L 'b'
+#define CH_BOT_U 'B'
+#define CH_PROFILE_L 'f'
+#define CH_PROFILE_U 'F'
+#define CH_P1_LEFT_L 'a' // versus, the second player has the arrows
+#define CH_P1_LEFT_U 'A'
+#define CH_P1_RIGHT_L 'd'
+#define CH_P1_RIGHT_U 'D'
+#define CH_P1_ROTATE_L 'w'
+#define CH_P1_ROTATE_U 'W'
+#define CH_P1_DOWN_L 's'
+#define CH_P1_DOWN_U 'S'
+
+#define FILE_SCORE "leaderboard.dat"
+#define FILE_FRAME_STATS "frame_stats.json"
+#define FILE_BROADCAST "tetris.sock" // spectators' socket, unless one is given
 
 typedef enum custom_color_t
 {
@@ -127,19 +85,4 @@ typedef enum custom_color_t
 	CUSTOM_COLOR_WHITE_HIGH	   = 47
 } custom_color_t;
 
-typedef struct score_t
-{
-	uint16_t current;
-	uint16_t record;
-	// next members are used to show animated score on screen
-	uint16_t current_label;
-	uint16_t record_label;
-} score_t;
-
-typedef struct vec2_t
-{
-	float32_t x;
-	float32_t y;
-} vec2_t;
-
 #endif
\ No newline at end of file
@@ -0,0 +1,321 @@
+#include "bot.h"
+
+// board evaluation weights, from a genetic search over the same four features
+static const float32_t c_weight_height	  = -0.510066;
+static const float32_t c_weight_lines	  = 0.760666;
+static const float32_t c_weight_holes	  = -0.35663;
+static const float32_t c_weight_bumpiness = -0.184483;
+static const float32_t c_score_invalid	  = -1e9;
+static const uint8_t   c_max_actions	  = 16;  // per shape, then it's dropped where it is
+static const float32_t c_headless_step	  = 1.0; // longer than any engine animation
+static const uint16_t  c_window_margin	  = SHAPE_MAX_SIZE * 2; // rows above the stack the shape and lookahead can reach
+
+// the rows the bot works on, the bottom of the board from c_window_margin
+// rows above the highest filled one. The rows above are empty and can't be
+// reached, so they're left out of every copy and scan
+typedef struct window_t
+{
+	board_row_t rows[BOARD_ROWS_MAX];
+	board_row_t row_full;
+	uint16_t	height;
+	uint8_t		cols;
+} window_t;
+
+static void		 plan(bot_t *bot, const engine_t *engine);
+static float32_t evaluate_placements(const window_t *window, shape_type_t type, int8_t lookahead_type, uint8_t lines, uint8_t *best_rotation, int16_t *best_x);
+static bool		 is_rotation_repeated(shape_type_t type, uint8_t rotation);
+static bool		 place_shape(window_t *window, shape_type_t type, uint8_t rotation, int16_t x, uint8_t *lines);
+static bool		 shape_overlaps(const window_t *window, const shape_rotation_t *rotation, int16_t x, int16_t y);
+static uint8_t	 clear_rows(window_t *window);
+static float32_t evaluate_board(const window_t *window, uint8_t lines);
+static float32_t evaluate_rows(const board_row_t *rows, uint16_t height, uint8_t cols, uint8_t lines);
+static void		 copy_window(window_t *dest, const window_t *source);
+
+void bot_init(bot_t *bot)
+{
+	memset(bot, 0, sizeof(bot_t));
+}
+
+// one action per call, towards the placement chosen for the current shape
+player_action_t bot_next_action(bot_t *bot, const engine_t *engine)
+{
+	const shape_t *shape = &engine->current_shape;
+
+	// rows being cleared, the board isn't final yet
+	if (FIXED_SPARSE_SET_LENGTH(engine->filled_rows_indexes) > 0)
+	{
+		return PLAYER_ACTION_IDLE;
+	}
+
+	if (!bot->planned || bot->shapes_count != engine->shapes_count)
+	{
+		plan(bot, engine);
+	}
+
+	// blocked on its way (rotation or moves reverted), give up on the target
+	if (bot->actions_count++ >= c_max_actions)
+	{
+		return PLAYER_ACTION_HARD_DROP;
+	}
+
+	if (shape->rotation != bot->target_rotation)
+	{
+		return PLAYER_ACTION_ROTATE;
+	}
+	else if (shape->pos.x < bot->target_x)
+	{
+		return PLAYER_ACTION_MOVE_RIGHT;
+	}
+	else if (shape->pos.x > bot->target_x)
+	{
+		return PLAYER_ACTION_MOVE_LEFT;
+	}
+
+	return PLAYER_ACTION_HARD_DROP;
+}
+
+// headless play, at full speed: animations are skipped by stepping the
+// engine long enough on the hard drop. Returns the engine steps played
+uint32_t bot_play_shape(bot_t *bot, engine_t *engine)
+{
+	uint32_t		shapes_count = engine->shapes_count;
+	uint32_t		steps		 = 0;
+	player_action_t action;
+
+	while (!engine_is_game_over(engine) && engine->shapes_count == shapes_count)
+	{
+		action = bot_next_action(bot, engine);
+		engine_step(engine, action, action == PLAYER_ACTION_HARD_DROP ? c_headless_step : 0);
+		steps++;
+	}
+
+	return steps;
+}
+
+static void plan(bot_t *bot, const engine_t *engine)
+{
+	window_t window;
+	uint16_t top = engine->board_top_row_filled > c_window_margin ? engine->board_top_row_filled - c_window_margin : 0;
+
+	window.row_full = engine->board_row_full;
+	window.height	= engine->board_size.rows - top;
+	window.cols		= engine->board_size.cols;
+	memcpy(window.rows, engine->board + top, sizeof(board_row_t) * window.height);
+
+	bot->planned		 = true;
+	bot->shapes_count	 = engine->shapes_count;
+	bot->actions_count	 = 0;
+	bot->target_rotation = engine->current_shape.rotation;
+	bot->target_x		 = engine->current_shape.pos.x;
+
+	evaluate_placements(&window, engine->current_shape.type, engine->next_shape.type, 0, &bot->target_rotation, &bot->target_x);
+}
+
+// best score of every rotation and column for the shape, where each one is
+// scored by the best placement of the lookahead shape (if any) after it
+static float32_t evaluate_placements(const window_t *window, shape_type_t type, int8_t lookahead_type, uint8_t lines, uint8_t *best_rotation, int16_t *best_x)
+{
+	window_t	window_placed;
+	float32_t	best_score = c_score_invalid;
+	float32_t	score	   = 0;
+	uint8_t		lines_placed;
+	uint8_t		rotation_unused;
+	int16_t		x_unused;
+
+	for (uint8_t rotation = 0; rotation < SHAPE_ROTATIONS_COUNT; rotation++)
+	{
+		const shape_rotation_t *shape_rotation = &c_shape_rotations[type][rotation];
+		int16_t					max_x		   = window->cols - shape_rotation->width - shape_rotation->padding_left;
+
+		if (is_rotation_repeated(type, rotation))
+		{
+			continue;
+		}
+
+		for (int16_t x = -shape_rotation->padding_left; x <= max_x; x++)
+		{
+			copy_window(&window_placed, window);
+
+			if (!place_shape(&window_placed, type, rotation, x, &lines_placed))
+			{
+				continue;
+			}
+
+			if (lookahead_type >= 0)
+			{
+				score = evaluate_placements(&window_placed, lookahead_type, -1, lines + lines_placed, &rotation_unused, &x_unused);
+			}
+			else
+			{
+				score = evaluate_board(&window_placed, lines + lines_placed);
+			}
+
+			if (score > best_score)
+			{
+				best_score	   = score;
+				*best_rotation = rotation;
+				*best_x		   = x;
+			}
+		}
+	}
+
+	return best_score;
+}
+
+// same cells as a previous rotation (O, and I, S, Z halves), so the same
+// boards would be evaluated again
+static bool is_rotation_repeated(shape_type_t type, uint8_t rotation)
+{
+	const shape_rotation_t *shape_rotation = &c_shape_rotations[type][rotation];
+
+	for (uint8_t i = 0; i < rotation; i++)
+	{
+		const shape_rotation_t *prev_rotation = &c_shape_rotations[type][i];
+
+		if (prev_rotation->padding_top == shape_rotation->padding_top &&
+			memcmp(prev_rotation->masks, shape_rotation->masks, sizeof(shape_rotation->masks)) == 0)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// drops the shape from the top of the board, false when there's no room
+static bool place_shape(window_t *window, shape_type_t type, uint8_t rotation, int16_t x, uint8_t *lines)
+{
+	const shape_rotation_t *shape_rotation = &c_shape_rotations[type][rotation];
+	int16_t					y			   = 0;
+	int16_t					top_y		   = 0;
+
+	if (shape_overlaps(window, shape_rotation, x, y))
+	{
+		return false;
+	}
+
+	// nothing to collide with above the highest filled row
+	while (top_y < window->height && !window->rows[top_y])
+	{
+		top_y++;
+	}
+
+	if (top_y - shape_rotation->padding_top - shape_rotation->height > y)
+	{
+		y = top_y - shape_rotation->padding_top - shape_rotation->height;
+	}
+
+	while ((y + 1 + shape_rotation->padding_top + shape_rotation->height) <= window->height &&
+		   !shape_overlaps(window, shape_rotation, x, y + 1))
+	{
+		y++;
+	}
+
+	for (uint8_t row = 0; row < shape_rotation->height; row++)
+	{
+		window->rows[y + shape_rotation->padding_top + row] |= (board_row_t)shape_rotation->masks[row] << (x + shape_rotation->padding_left);
+	}
+
+	*lines = clear_rows(window);
+
+	return true;
+}
+
+static bool shape_overlaps(const window_t *window, const shape_rotation_t *rotation, int16_t x, int16_t y)
+{
+	for (uint8_t row = 0; row < rotation->height; row++)
+	{
+		if (window->rows[y + rotation->padding_top + row] & ((board_row_t)rotation->masks[row] << (x + rotation->padding_left)))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static uint8_t clear_rows(window_t *window)
+{
+	int16_t dest  = window->height - 1;
+	uint8_t lines = 0;
+
+	for (int16_t y = window->height - 1; y >= 0; y--)
+	{
+		if (window->rows[y] == window->row_full)
+		{
+			lines++;
+		}
+		else
+		{
+			window->rows[dest--] = window->rows[y];
+		}
+	}
+
+	for (; dest >= 0; dest--)
+	{
+		window->rows[dest] = 0;
+	}
+
+	return lines;
+}
+
+// the standard width (10x20 and 10x40 boards) gets its own copy of
+// evaluate_rows, with a constant width its loops are unrolled
+static float32_t evaluate_board(const window_t *window, uint8_t lines)
+{
+	if (window->cols == BOARD_COLS_DEFAULT)
+	{
+		return evaluate_rows(window->rows, window->height, BOARD_COLS_DEFAULT, lines);
+	}
+
+	return evaluate_rows(window->rows, window->height, window->cols, lines);
+}
+
+// aggregate column height, cleared lines, holes (empty cells with a filled
+// one above) and bumpiness (height differences between adjacent columns)
+static inline float32_t evaluate_rows(const board_row_t *rows, uint16_t height, uint8_t cols, uint8_t lines)
+{
+	uint16_t	heights[BOARD_COLS_MAX] = { 0 };
+	board_row_t covered					= 0;
+	uint32_t	heights_sum				= 0;
+	uint32_t	holes					= 0;
+	uint32_t	bumpiness				= 0;
+
+	for (uint16_t y = 0; y < height; y++)
+	{
+		board_row_t row	 = rows[y];
+		board_row_t tops = row & ~covered;
+
+		holes += __builtin_popcountll(covered & ~row);
+		covered |= row;
+
+		for (uint8_t x = 0; tops; x++, tops >>= 1)
+		{
+			if (tops & 1)
+			{
+				heights[x] = height - y;
+			}
+		}
+	}
+
+	for (uint8_t x = 0; x < cols; x++)
+	{
+		heights_sum += heights[x];
+
+		if (x > 0)
+		{
+			bumpiness += abs(heights[x] - heights[x - 1]);
+		}
+	}
+
+	return (c_weight_height * heights_sum) + (c_weight_lines * lines) + (c_weight_holes * holes) + (c_weight_bumpiness * bumpiness);
+}
+
+// only the rows in use
+static void copy_window(window_t *dest, const window_t *source)
+{
+	dest->row_full = source->row_full;
+	dest->height   = source->height;
+	dest->cols	   = source->cols;
+	memcpy(dest->rows, source->rows, sizeof(board_row_t) * source->height);
+}
\ No newline at end of file
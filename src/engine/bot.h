@@ -0,0 +1,22 @@
+#ifndef BOT_H
+#define BOT_H
+
+#include "engine.h"
+
+// autoplayer. For each new shape it picks the placement (rotation and column)
+// with the best board evaluation, looking one shape ahead (next_shape), then
+// plays the same actions a player would to get it there
+typedef struct bot_t
+{
+	uint32_t shapes_count; // shape the target was chosen for
+	int16_t	 target_x;
+	uint8_t	 target_rotation;
+	uint8_t	 actions_count; // already played for the current shape
+	bool	 planned;
+} bot_t;
+
+void			bot_init(bot_t *bot);
+player_action_t bot_next_action(bot_t *bot, const engine_t *engine);
+uint32_t		bot_play_shape(bot_t *bot, engine_t *engine);
+
+#endif
\ No newline at end of file
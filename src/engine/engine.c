@@ -0,0 +1,508 @@
+#include "engine.h"
+#include <stddef.h>
+
+static const uint8_t   c_speedup_velocity				= 20;
+static const uint8_t   c_max_level						= 10;
+static const float32_t c_shape_base_velocity			= 1; // 1 row per second
+static const float32_t c_filled_rows_animation_lifetime = 0.3;
+static const float32_t c_prev_shape_animation_lifetime	= 0.3;
+static const uint8_t   c_garbage_color					= COLOR_PAIR_WHITE_MEDIUM;
+
+static float32_t	get_drop_interval(const engine_t *engine);
+static void			update_current_shape(engine_t *engine, float32_t delta_time);
+static void			rotate_shape(engine_t *engine, bool backward);
+static void			drop_shape(engine_t *engine);
+static void			handle_collision(engine_t *engine);
+static bool			shape_overlaps_board(const engine_t *engine, const shape_t *shape, int16_t pos_y);
+static void			lock_shape(engine_t *engine);
+static void			set_shape_on_board(engine_t *engine);
+static void			scan_board_filled_rows(engine_t *engine);
+static void			process_board_filled_rows(engine_t *engine, float32_t delta_time);
+static void			process_prev_shape_animation(engine_t *engine, float32_t delta_time);
+static void			set_prev_shape(engine_t *engine);
+static void			set_next_shape(engine_t *engine);
+static void			set_current_shape(engine_t *engine);
+
+void engine_init(engine_t *engine, uint32_t seed, randomizer_type_t randomizer_type, board_size_t board_size)
+{
+	ASSERT(board_size.rows >= BOARD_ROWS_MIN && board_size.rows <= BOARD_ROWS_MAX &&
+		   board_size.cols >= BOARD_COLS_MIN && board_size.cols <= BOARD_COLS_MAX);
+
+	// the board is sized for the largest one, only the rows used are cleared
+	memset(engine, 0, offsetof(engine_t, filled_rows_indexes));
+	memset(engine->board, 0, sizeof(board_row_t) * board_size.rows);
+	memset(engine->board_colors, 0, sizeof(uint8_t) * board_size.rows * board_size.cols);
+
+	engine->board_size			 = board_size;
+	engine->board_row_full		 = (board_row_t)-1 >> (BOARD_COLS_MAX - board_size.cols);
+	engine->player_action		 = PLAYER_ACTION_IDLE;
+	engine->level				 = 1;
+	engine->board_top_row_filled = board_size.rows - 1;
+
+	FIXED_SPARSE_SET_INIT(engine->filled_rows_indexes);
+	randomizer_init(&engine->randomizer, seed, randomizer_type);
+	set_next_shape(engine);
+	set_current_shape(engine);
+	set_next_shape(engine);
+}
+
+// nothing to release anymore, kept for callers and future resources
+void engine_dispose(engine_t *engine)
+{
+	(void)engine;
+}
+
+// the whole game, but only the rows of the board in use are copied (an
+// engine_t is sized for the largest board)
+void engine_copy(engine_t *dest, const engine_t *source)
+{
+	uint16_t rows = source->board_size.rows;
+
+	memcpy(dest, source, offsetof(engine_t, filled_rows_indexes));
+	FIXED_SPARSE_SET_COPY(dest->filled_rows_indexes, source->filled_rows_indexes, rows);
+	memcpy(dest->board, source->board, sizeof(board_row_t) * rows);
+	memcpy(dest->board_colors, source->board_colors, sizeof(uint8_t) * rows * source->board_size.cols);
+}
+
+void engine_step(engine_t *engine, player_action_t action, float32_t delta_time)
+{
+	if (engine_is_game_over(engine))
+	{
+		return;
+	}
+
+	engine->velocity	  = engine->level;
+	engine->player_action = action;
+
+	update_current_shape(engine, delta_time);
+	handle_collision(engine);
+	process_board_filled_rows(engine, delta_time);
+	process_prev_shape_animation(engine, delta_time);
+}
+
+bool engine_is_game_over(const engine_t *engine)
+{
+	return engine->board_top_row_filled == 0;
+}
+
+int16_t engine_get_shape_dest_pos_y(const engine_t *engine)
+{
+	const shape_t			*shape	  = &engine->current_shape;
+	const shape_rotation_t *rotation = SHAPE_ROTATION(*shape);
+	int16_t					y		 = shape->pos.y;
+	int16_t					free_y	 = engine->board_top_row_filled - rotation->padding_top - rotation->height;
+
+	// nothing to collide with above the highest filled row, on tall boards
+	// most of the way down
+	if (free_y > y && !shape_overlaps_board(engine, shape, free_y))
+	{
+		y = free_y;
+	}
+
+	while ((y + 1 + rotation->padding_top + rotation->height) <= engine->board_size.rows &&
+		   !shape_overlaps_board(engine, shape, y + 1))
+	{
+		y++;
+	}
+
+	return y;
+}
+
+// seconds until the current shape falls one row by itself
+float32_t engine_get_drop_time_left(const engine_t *engine)
+{
+	float32_t time_left = get_drop_interval(engine) - engine->current_shape_elapsed_time;
+
+	return time_left > 0 ? time_left : 0;
+}
+
+// "<cols>x<rows>", e.g. 10x40. False when malformed or out of the limits
+bool engine_parse_board_size(const char *value, board_size_t *board_size)
+{
+	char *end  = NULL;
+	long  cols = strtol(value, &end, 10);
+	long  rows = *end == 'x' ? strtol(end + 1, &end, 10) : 0;
+
+	if (*end != '\0' ||
+		cols < BOARD_COLS_MIN || cols > BOARD_COLS_MAX ||
+		rows < BOARD_ROWS_MIN || rows > BOARD_ROWS_MAX)
+	{
+		return false;
+	}
+
+	board_size->rows = rows;
+	board_size->cols = cols;
+
+	return true;
+}
+
+// upcoming shapes, 0 is next_shape, up to ENGINE_LOOKAHEAD_MAX - 1
+shape_type_t engine_peek_shape(const engine_t *engine, uint8_t index)
+{
+	ASSERT(index < ENGINE_LOOKAHEAD_MAX);
+
+	return index == 0 ? engine->next_shape.type : randomizer_peek(&engine->randomizer, index - 1);
+}
+
+// filled rows or last shape highlight still running, they change every frame
+bool engine_is_animating(const engine_t *engine)
+{
+	return engine->prev_shape_active || engine_is_clearing_rows(engine);
+}
+
+// filled rows are highlighted for a while before they're removed
+bool engine_is_clearing_rows(const engine_t *engine)
+{
+	return FIXED_SPARSE_SET_LENGTH(engine->filled_rows_indexes) > 0;
+}
+
+// rows sent by an opponent, full but for a hole at hole_x, pushed in from the
+// bottom. The board and the falling shape move up, blocks pushed to the top
+// row (or off the board) end the game. Not while rows are being cleared,
+// their indexes would be stale
+void engine_add_garbage(engine_t *engine, uint8_t rows, uint8_t hole_x)
+{
+	shape_t *shape		= &engine->current_shape;
+	uint16_t board_rows = engine->board_size.rows;
+	uint8_t	 board_cols = engine->board_size.cols;
+	bool	 topped_out = false;
+
+	ASSERT(!engine_is_clearing_rows(engine) && hole_x < board_cols);
+
+	if (engine_is_game_over(engine) || rows == 0)
+	{
+		return;
+	}
+
+	rows = rows < board_rows ? rows : board_rows - 1;
+
+	for (uint8_t y = 0; y <= rows; y++)
+	{
+		topped_out = topped_out || engine->board[y];
+	}
+
+	// the empty rows above the highest filled one stay where they are
+	uint16_t first = engine->board_top_row_filled > rows ? engine->board_top_row_filled : rows;
+
+	memmove(engine->board + first - rows, engine->board + first, sizeof(board_row_t) * (board_rows - first));
+	memmove(engine->board_colors + ((first - rows) * board_cols), engine->board_colors + (first * board_cols), sizeof(uint8_t) * (board_rows - first) * board_cols);
+
+	for (uint16_t y = board_rows - rows; y < board_rows; y++)
+	{
+		engine->board[y] = engine->board_row_full & ~((board_row_t)1 << hole_x);
+		memset(engine->board_colors + (y * board_cols), c_garbage_color, sizeof(uint8_t) * board_cols);
+		engine->board_colors[(board_cols * y) + hole_x] = 0;
+	}
+
+	// a lower bound of the top row, which is empty unless topped out
+	engine->board_top_row_filled = engine->board_top_row_filled > rows + 1 ? engine->board_top_row_filled - rows : 1;
+	engine->prev_shape.pos.y -= rows;
+
+	for (uint8_t i = 0; i < rows && shape->pos.y > 0 && shape_overlaps_board(engine, shape, shape->pos.y); i++)
+	{
+		shape->pos.y--;
+	}
+
+	shape->prev_pos = shape->pos;
+
+	if (topped_out || shape_overlaps_board(engine, shape, shape->pos.y))
+	{
+		engine->board_top_row_filled = 0;
+	}
+
+	if (engine->shape_shadow_enabled)
+	{
+		shape->shadow_pos_y = engine_get_shape_dest_pos_y(engine);
+	}
+}
+
+static float32_t get_drop_interval(const engine_t *engine)
+{
+	return c_shape_base_velocity - (engine->velocity * 0.1);
+}
+
+static void update_current_shape(engine_t *engine, float32_t delta_time)
+{
+	shape_t *shape = &engine->current_shape;
+
+	engine->current_shape_elapsed_time += delta_time;
+
+	shape->prev_pos = shape->pos;
+
+	if (engine->player_action == PLAYER_ACTION_MOVE_LEFT)
+	{
+		shape->pos.x -= 1;
+	}
+	else if (engine->player_action == PLAYER_ACTION_MOVE_RIGHT)
+	{
+		shape->pos.x += 1;
+	}
+	else if (engine->player_action == PLAYER_ACTION_ROTATE)
+	{
+		rotate_shape(engine, false);
+	}
+	else if (engine->player_action == PLAYER_ACTION_SPEEDUP && engine->level < c_speedup_velocity)
+	{
+		engine->velocity = c_speedup_velocity;
+	}
+
+	if (engine->player_action == PLAYER_ACTION_HARD_DROP)
+	{
+		drop_shape(engine);
+	}
+	else if (engine->current_shape_elapsed_time >= get_drop_interval(engine))
+	{
+		engine->current_shape_elapsed_time = 0;
+		shape->pos.y += 1;
+	}
+
+	if (engine->shape_shadow_enabled)
+	{
+		engine->current_shape.shadow_pos_y = engine_get_shape_dest_pos_y(engine);
+	}
+}
+
+static void rotate_shape(engine_t *engine, bool backward)
+{
+	shape_t *shape = &engine->current_shape;
+
+	shape->rotation = (shape->rotation + (backward ? SHAPE_ROTATIONS_COUNT - 1 : 1)) % SHAPE_ROTATIONS_COUNT;
+}
+
+static void drop_shape(engine_t *engine)
+{
+	engine->current_shape.pos.y = engine_get_shape_dest_pos_y(engine);
+	lock_shape(engine);
+}
+
+static void handle_collision(engine_t *engine)
+{
+	shape_t				   *shape	 = &engine->current_shape;
+	const shape_rotation_t *rotation = SHAPE_ROTATION(*shape);
+
+	// side board collision
+	if ((shape->pos.x + rotation->padding_left) < 0)
+	{
+		shape->pos.x++;
+	}
+	else if ((shape->pos.x + rotation->padding_left + rotation->width) > engine->board_size.cols)
+	{
+		shape->pos.x = engine->board_size.cols - rotation->width - rotation->padding_left;
+	}
+
+	// bottom board collision
+	int16_t shape_bottom_y = shape->pos.y + rotation->padding_top + rotation->height;
+	bool	y_collided	   = shape_bottom_y > engine->board_size.rows;
+
+	// board blocks collision
+	if (!y_collided && shape_bottom_y > engine->board_top_row_filled)
+	{
+		y_collided = shape_overlaps_board(engine, shape, shape->pos.y);
+	}
+
+	if (y_collided)
+	{
+		if (engine->player_action == PLAYER_ACTION_ROTATE)
+		{
+			rotate_shape(engine, true);
+		}
+		else
+		{
+			shape->pos = shape->prev_pos;
+		}
+
+		if (engine->player_action != PLAYER_ACTION_MOVE_LEFT &&
+			engine->player_action != PLAYER_ACTION_MOVE_RIGHT &&
+			engine->player_action != PLAYER_ACTION_ROTATE)
+		{
+			lock_shape(engine);
+		}
+	}
+}
+
+static bool shape_overlaps_board(const engine_t *engine, const shape_t *shape, int16_t pos_y)
+{
+	const shape_rotation_t *rotation	 = SHAPE_ROTATION(*shape);
+	int16_t					shape_left_x = shape->pos.x + rotation->padding_left;
+	int16_t					shape_top_y	 = pos_y + rotation->padding_top;
+
+#ifdef PROFILE
+	// a counter only, the engine itself is never const
+	((engine_t *)engine)->collision_checks++;
+#endif
+
+	// out of the board sides, handle_collision will move it back
+	if (shape_left_x < 0 || (shape_left_x + rotation->width) > engine->board_size.cols)
+	{
+		return true;
+	}
+
+	for (uint8_t y = 0; y < rotation->height; y++)
+	{
+		if (engine->board[shape_top_y + y] & ((board_row_t)rotation->masks[y] << shape_left_x))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static void lock_shape(engine_t *engine)
+{
+	set_shape_on_board(engine);
+	scan_board_filled_rows(engine);
+	set_prev_shape(engine);
+	set_current_shape(engine);
+	set_next_shape(engine);
+}
+
+static void set_shape_on_board(engine_t *engine)
+{
+	const shape_t		   *shape		 = &engine->current_shape;
+	const shape_rotation_t *rotation	 = SHAPE_ROTATION(*shape);
+	uint8_t					color		 = c_shape_colors[shape->type];
+	uint16_t				height		 = shape->pos.y;
+	uint8_t					shape_left_x = shape->pos.x + rotation->padding_left;
+	uint16_t				shape_top_y	 = shape->pos.y + rotation->padding_top;
+
+	if (height < engine->board_top_row_filled)
+	{
+		engine->board_top_row_filled = height;
+	}
+
+	for (uint8_t y = 0; y < rotation->height; y++)
+	{
+		uint8_t	 mask	= rotation->masks[y];
+		uint8_t *colors = engine->board_colors + (engine->board_size.cols * (shape_top_y + y)) + shape_left_x;
+
+		engine->board[shape_top_y + y] |= (board_row_t)mask << shape_left_x;
+
+		for (uint8_t x = 0; mask; x++, mask >>= 1)
+		{
+			if (mask & 1)
+			{
+				colors[x] = color;
+			}
+		}
+	}
+
+	engine->shapes_count++;
+}
+
+// only the rows of the shape just locked can have been filled
+static void scan_board_filled_rows(engine_t *engine)
+{
+	const shape_rotation_t *rotation = SHAPE_ROTATION(engine->current_shape);
+	int16_t					top_y	 = engine->current_shape.pos.y + rotation->padding_top;
+
+	engine->filled_rows_elapsed_time = 0;
+
+	for (int16_t y = top_y; y < top_y + rotation->height; y++)
+	{
+		if (engine->board[y] == engine->board_row_full)
+		{
+			FIXED_SPARSE_SET_ADD(engine->filled_rows_indexes, y);
+		}
+	}
+}
+
+// rows between the highest and lowest filled ones are moved one by one, the
+// ones above them (up to the highest filled row) all at once
+static void process_board_filled_rows(engine_t *engine, float32_t delta_time)
+{
+	uint16_t filled_rows_length = FIXED_SPARSE_SET_LENGTH(engine->filled_rows_indexes);
+	uint8_t	 cols				= engine->board_size.cols;
+	uint16_t top				= engine->board_top_row_filled;
+	uint16_t highest			= engine->board_size.rows;
+	uint16_t lowest				= 0;
+
+	if (filled_rows_length == 0)
+	{
+		return;
+	}
+
+	engine->filled_rows_elapsed_time += delta_time;
+
+	if (engine->filled_rows_elapsed_time < c_filled_rows_animation_lifetime)
+	{
+		return;
+	}
+
+	for (uint16_t i = 0; i < filled_rows_length; i++)
+	{
+		uint16_t y = FIXED_SPARSE_SET_GET(engine->filled_rows_indexes, i);
+
+		highest = y < highest ? y : highest;
+		lowest	= y > lowest ? y : lowest;
+	}
+
+	uint16_t dest = lowest;
+
+	for (int16_t y = lowest; y >= highest; y--)
+	{
+		if (!FIXED_SPARSE_SET_CONTAINS(engine->filled_rows_indexes, y))
+		{
+			engine->board[dest] = engine->board[y];
+			memcpy(engine->board_colors + (dest * cols), engine->board_colors + (y * cols), sizeof(uint8_t) * cols);
+			dest--;
+		}
+	}
+
+	memmove(engine->board + top + filled_rows_length, engine->board + top, sizeof(board_row_t) * (highest - top));
+	memmove(engine->board_colors + ((top + filled_rows_length) * cols), engine->board_colors + (top * cols), sizeof(uint8_t) * (highest - top) * cols);
+
+	FIXED_SPARSE_SET_CLEAR(engine->filled_rows_indexes);
+
+	memset(engine->board + top, 0, sizeof(board_row_t) * filled_rows_length);
+	memset(engine->board_colors + (top * cols), 0, sizeof(uint8_t) * filled_rows_length * cols);
+	engine->board_top_row_filled += filled_rows_length;
+
+	engine->score += filled_rows_length;
+	engine->lines += filled_rows_length;
+
+	if (engine->level < c_max_level)
+	{
+		engine->level = (uint8_t)ceil((float32_t)engine->score / 10);
+	}
+}
+
+static void process_prev_shape_animation(engine_t *engine, float32_t delta_time)
+{
+	if (!engine->prev_shape_active)
+	{
+		return;
+	}
+
+	engine->prev_shape_elapsed_time += delta_time;
+
+	if (engine->prev_shape_elapsed_time >= c_prev_shape_animation_lifetime)
+	{
+		engine->prev_shape_active = false;
+	}
+}
+
+static void set_next_shape(engine_t *engine)
+{
+	engine->next_shape.type		= randomizer_next(&engine->randomizer);
+	engine->next_shape.rotation = 0;
+}
+
+static void set_prev_shape(engine_t *engine)
+{
+	engine->prev_shape				= engine->current_shape;
+	engine->prev_shape_active		= true;
+	engine->prev_shape_elapsed_time = 0;
+}
+
+static void set_current_shape(engine_t *engine)
+{
+	shape_t				   *shape	 = &engine->current_shape;
+	const shape_rotation_t *rotation = &c_shape_rotations[engine->next_shape.type][0];
+
+	shape->type		= engine->next_shape.type;
+	shape->rotation = 0;
+	shape->pos.x	= (engine->board_size.cols - rotation->width) / 2 - rotation->padding_left;
+	shape->pos.y	= 0;
+	shape->prev_pos = shape->pos;
+}
\ No newline at end of file
@@ -0,0 +1,85 @@
+#ifndef ENGINE_H
+#define ENGINE_H
+
+#include "../data_structures/data_structures.h"
+#include "../shapes.h"
+#include "../types.h"
+#include "randomizer.h"
+
+#define BOARD_ROWS_DEFAULT 20
+#define BOARD_COLS_DEFAULT 10
+#define BOARD_ROWS_MIN SHAPE_MAX_SIZE
+#define BOARD_COLS_MIN SHAPE_MAX_SIZE
+#define BOARD_ROWS_MAX 1000
+#define BOARD_COLS_MAX 64 // bits of a board_row_t
+#define BOARD_SIZE_DEFAULT ((board_size_t){ .rows = BOARD_ROWS_DEFAULT, .cols = BOARD_COLS_DEFAULT })
+#define ENGINE_LOOKAHEAD_MAX (RANDOMIZER_QUEUE_CAPACITY + 1) // next_shape included
+
+// one occupancy bit per cell, bit x is column x. A whole row is tested (full,
+// under a shape) or moved at once, so the width costs nothing
+typedef uint64_t board_row_t;
+
+// set at init, within the BOARD_*_MIN and BOARD_*_MAX limits
+typedef struct board_size_t
+{
+	uint16_t rows;
+	uint8_t	 cols;
+} board_size_t;
+
+typedef FIXED_SPARSE_SET_T(BOARD_ROWS_MAX) rows_set_t;
+
+typedef enum player_action_t
+{
+	PLAYER_ACTION_IDLE		 = 0,
+	PLAYER_ACTION_MOVE_LEFT	 = 1,
+	PLAYER_ACTION_MOVE_RIGHT = 2,
+	PLAYER_ACTION_ROTATE	 = 3,
+	PLAYER_ACTION_SPEEDUP	 = 4,
+	PLAYER_ACTION_HARD_DROP	 = 5
+} player_action_t;
+
+// whole state of a single game. it doesn't depend on curses nor on globals,
+// so any number of them can run side by side (and without a terminal)
+typedef struct engine_t
+{
+	board_size_t board_size;
+	board_row_t	 board_row_full; // every column filled
+	shape_t		 next_shape;
+	shape_t		 current_shape;
+	shape_t		 prev_shape;
+	bool		 prev_shape_active;
+	float32_t	 current_shape_elapsed_time;
+	float32_t	 filled_rows_elapsed_time;
+	float32_t	 prev_shape_elapsed_time;
+	randomizer_t randomizer;
+	uint32_t	 shapes_count; // shapes locked on the board
+	uint32_t	 lines;		   // cleared rows, score doesn't hold long games
+	uint16_t	 score;		   // cleared rows
+	uint8_t		 player_action;
+	uint8_t		 level;
+	uint8_t		 velocity;
+	uint16_t	 board_top_row_filled;
+	bool		 shape_shadow_enabled;
+#ifdef PROFILE
+	uint32_t collision_checks; // shape_overlaps_board calls, reset by the reader
+#endif
+	// sized for the largest board, only its first board_size.rows rows are used
+	rows_set_t	filled_rows_indexes;
+	board_row_t board[BOARD_ROWS_MAX];
+	uint8_t		board_colors[BOARD_ROWS_MAX * BOARD_COLS_MAX]; // rows of board_size.cols, only used for rendering
+} engine_t;
+
+void			engine_init(engine_t *engine, uint32_t seed, randomizer_type_t randomizer_type, board_size_t board_size);
+void			engine_dispose(engine_t *engine);
+void			engine_copy(engine_t *dest, const engine_t *source);
+void			engine_step(engine_t *engine, player_action_t action, float32_t delta_time);
+bool			engine_is_game_over(const engine_t *engine);
+bool			engine_is_animating(const engine_t *engine);
+bool			engine_is_clearing_rows(const engine_t *engine);
+void			engine_add_garbage(engine_t *engine, uint8_t rows, uint8_t hole_x);
+int16_t			engine_get_shape_dest_pos_y(const engine_t *engine);
+float32_t		engine_get_drop_time_left(const engine_t *engine);
+shape_type_t	engine_peek_shape(const engine_t *engine, uint8_t index);
+bool			engine_parse_board_size(const char *value, board_size_t *board_size);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,132 @@
+#include "randomizer.h"
+
+static uint64_t		splitmix64(uint64_t *state);
+static uint32_t		rotl(uint32_t value, uint8_t bits);
+static shape_type_t generate_shape(randomizer_t *randomizer);
+
+void random_seed(random_t *random, uint64_t seed)
+{
+	uint64_t value;
+
+	// splitmix64 never gives an all zero state
+	for (uint8_t i = 0; i < 4; i += 2)
+	{
+		value				 = splitmix64(&seed);
+		random->state[i]	 = (uint32_t)value;
+		random->state[i + 1] = (uint32_t)(value >> 32);
+	}
+}
+
+uint32_t random_next(random_t *random)
+{
+	uint32_t *s		 = random->state;
+	uint32_t  result = rotl(s[1] * 5, 7) * 9;
+	uint32_t  t		 = s[1] << 9;
+
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = rotl(s[3], 11);
+
+	return result;
+}
+
+// [0, bound) without modulo bias (Lemire's multiply and reject)
+uint32_t random_below(random_t *random, uint32_t bound)
+{
+	uint64_t product   = (uint64_t)random_next(random) * bound;
+	uint32_t low	   = (uint32_t)product;
+	uint32_t threshold = 0;
+
+	ASSERT(bound > 0);
+
+	if (low < bound)
+	{
+		threshold = -bound % bound;
+
+		while (low < threshold)
+		{
+			product = (uint64_t)random_next(random) * bound;
+			low		= (uint32_t)product;
+		}
+	}
+
+	return (uint32_t)(product >> 32);
+}
+
+void randomizer_init(randomizer_t *randomizer, uint32_t seed, randomizer_type_t type)
+{
+	memset(randomizer, 0, sizeof(randomizer_t));
+
+	randomizer->type = type;
+	random_seed(&randomizer->random, seed);
+
+	for (uint8_t i = 0; i < RANDOMIZER_QUEUE_CAPACITY; i++)
+	{
+		randomizer->queue[i] = generate_shape(randomizer);
+	}
+}
+
+// takes the first shape of the queue and generates the one at its back
+shape_type_t randomizer_next(randomizer_t *randomizer)
+{
+	shape_type_t type = randomizer->queue[randomizer->queue_head];
+
+	randomizer->queue[randomizer->queue_head] = generate_shape(randomizer);
+	randomizer->queue_head					  = (randomizer->queue_head + 1) % RANDOMIZER_QUEUE_CAPACITY;
+
+	return type;
+}
+
+// index 0 is the shape randomizer_next will return
+shape_type_t randomizer_peek(const randomizer_t *randomizer, uint8_t index)
+{
+	ASSERT(index < RANDOMIZER_QUEUE_CAPACITY);
+
+	return randomizer->queue[(randomizer->queue_head + index) % RANDOMIZER_QUEUE_CAPACITY];
+}
+
+static uint64_t splitmix64(uint64_t *state)
+{
+	uint64_t z = (*state += 0x9e3779b97f4a7c15);
+
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+
+	return z ^ (z >> 31);
+}
+
+static uint32_t rotl(uint32_t value, uint8_t bits)
+{
+	return (value << bits) | (value >> (32 - bits));
+}
+
+static shape_type_t generate_shape(randomizer_t *randomizer)
+{
+	if (randomizer->type == RANDOMIZER_TYPE_UNIFORM)
+	{
+		return (shape_type_t)random_below(&randomizer->random, SHAPES_COUNT);
+	}
+
+	if (randomizer->bag_length == 0)
+	{
+		for (uint8_t i = 0; i < SHAPES_COUNT; i++)
+		{
+			randomizer->bag[i] = i;
+		}
+
+		randomizer->bag_length = SHAPES_COUNT;
+	}
+
+	// swap a random one of the shapes left with the last one and take it
+	uint8_t index = (uint8_t)random_below(&randomizer->random, randomizer->bag_length);
+	uint8_t type  = randomizer->bag[index];
+
+	randomizer->bag_length--;
+	randomizer->bag[index]					= randomizer->bag[randomizer->bag_length];
+	randomizer->bag[randomizer->bag_length] = type;
+
+	return (shape_type_t)type;
+}
\ No newline at end of file
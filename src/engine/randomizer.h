@@ -0,0 +1,41 @@
+#ifndef RANDOMIZER_H
+#define RANDOMIZER_H
+
+#include "../common.h"
+#include "../shapes.h"
+#include "../types.h"
+
+#define RANDOMIZER_QUEUE_CAPACITY 8 // shapes that can be looked ahead
+
+typedef enum randomizer_type_t
+{
+	RANDOMIZER_TYPE_UNIFORM = 0, // every shape equally likely each time
+	RANDOMIZER_TYPE_BAG		= 1	 // shuffled bags of the 7 shapes
+} randomizer_type_t;
+
+// xoshiro128** state, seeded through splitmix64
+typedef struct random_t
+{
+	uint32_t state[4];
+} random_t;
+
+// per-game shape sequence. The queue is always full, so shapes are generated
+// in the same order whatever is looked ahead, and a seed is a whole game
+typedef struct randomizer_t
+{
+	random_t		  random;
+	randomizer_type_t type;
+	uint8_t			  bag[SHAPES_COUNT];
+	uint8_t			  bag_length; // shapes left in the bag
+	uint8_t			  queue[RANDOMIZER_QUEUE_CAPACITY];
+	uint8_t			  queue_head;
+} randomizer_t;
+
+void		 random_seed(random_t *random, uint64_t seed);
+uint32_t	 random_next(random_t *random);
+uint32_t	 random_below(random_t *random, uint32_t bound);
+void		 randomizer_init(randomizer_t *randomizer, uint32_t seed, randomizer_type_t type);
+shape_type_t randomizer_next(randomizer_t *randomizer);
+shape_type_t randomizer_peek(const randomizer_t *randomizer, uint8_t index);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,264 @@
+#include "replay.h"
+
+#define REPLAY_RECORD_END 7
+#define REPLAY_ACTION_BITS 3
+#define REPLAY_ACTION_MASK ((1 << REPLAY_ACTION_BITS) - 1)
+#define REPLAY_ZERO_DELTA_TIME (1 << REPLAY_ACTION_BITS)
+#define REPLAY_HEADER_BITS (REPLAY_ACTION_BITS + 1)
+#define REPLAY_VERSION_DEFAULT_BOARD 2 // before the board size was recorded
+
+static void		write_varint(replay_t *replay, uint64_t value);
+static bool		read_varint(replay_t *replay, uint64_t *value);
+static uint64_t zigzag_encode(int64_t value);
+static int64_t	zigzag_decode(uint64_t value);
+
+// an empty replay file, nothing is written when it can't be created
+bool replay_create(replay_t *replay, const char *file, uint32_t seed, randomizer_type_t randomizer_type, board_size_t board_size)
+{
+	memset(replay, 0, sizeof(replay_t));
+
+	replay->seed			= seed;
+	replay->randomizer_type = randomizer_type;
+	replay->board_size		= board_size;
+	replay->file			= fopen(file, "wb");
+
+	if (!replay->file)
+	{
+		replay->failed = true;
+		return false;
+	}
+
+	fwrite(REPLAY_MAGIC, 1, strlen(REPLAY_MAGIC), replay->file);
+	fputc(REPLAY_VERSION, replay->file);
+	write_varint(replay, seed);
+	write_varint(replay, randomizer_type);
+	write_varint(replay, board_size.rows);
+	write_varint(replay, board_size.cols);
+
+	return !replay->failed;
+}
+
+void replay_record_step(replay_t *replay, player_action_t action, uint32_t delta_time_ms)
+{
+	if (replay->failed)
+	{
+		return;
+	}
+
+	if (delta_time_ms == 0)
+	{
+		write_varint(replay, REPLAY_ZERO_DELTA_TIME | action);
+		return;
+	}
+
+	int64_t delta = (int64_t)delta_time_ms - replay->delta_time_ms;
+
+	replay->delta_time_ms = delta_time_ms;
+	write_varint(replay, (zigzag_encode(delta) << REPLAY_HEADER_BITS) | action);
+}
+
+// writes the end record (when recording) and closes the file. False when
+// something couldn't be read or written
+bool replay_close(replay_t *replay, const engine_t *engine)
+{
+	if (!replay->file)
+	{
+		return false;
+	}
+
+	if (engine && !replay->failed)
+	{
+		write_varint(replay, REPLAY_RECORD_END);
+		write_varint(replay, engine->shapes_count);
+		write_varint(replay, engine->lines);
+	}
+
+	if (fclose(replay->file) != 0)
+	{
+		replay->failed = true;
+	}
+
+	replay->file = NULL;
+
+	return !replay->failed;
+}
+
+bool replay_open(replay_t *replay, const char *file)
+{
+	char	 magic[sizeof(REPLAY_MAGIC)] = { '\0' };
+	int		 version					 = 0;
+	uint64_t seed						 = 0;
+	uint64_t randomizer_type			 = 0;
+	uint64_t rows						 = BOARD_ROWS_DEFAULT;
+	uint64_t cols						 = BOARD_COLS_DEFAULT;
+
+	memset(replay, 0, sizeof(replay_t));
+	replay->file = fopen(file, "rb");
+
+	if (!replay->file)
+	{
+		replay->failed = true;
+		return false;
+	}
+
+	if (fread(magic, 1, strlen(REPLAY_MAGIC), replay->file) != strlen(REPLAY_MAGIC) ||
+		strcmp(magic, REPLAY_MAGIC) != 0 ||
+		((version = fgetc(replay->file)) != REPLAY_VERSION && version != REPLAY_VERSION_DEFAULT_BOARD) ||
+		!read_varint(replay, &seed) ||
+		!read_varint(replay, &randomizer_type) ||
+		randomizer_type > RANDOMIZER_TYPE_BAG ||
+		(version == REPLAY_VERSION && (!read_varint(replay, &rows) || !read_varint(replay, &cols))) ||
+		rows < BOARD_ROWS_MIN || rows > BOARD_ROWS_MAX ||
+		cols < BOARD_COLS_MIN || cols > BOARD_COLS_MAX)
+	{
+		replay->failed = true;
+		return false;
+	}
+
+	replay->seed			= (uint32_t)seed;
+	replay->randomizer_type = (randomizer_type_t)randomizer_type;
+	replay->board_size		= (board_size_t){ .rows = rows, .cols = cols };
+
+	return true;
+}
+
+// next step, false at the end of the replay (or on errors, see failed)
+bool replay_read_step(replay_t *replay, player_action_t *action, uint32_t *delta_time_ms)
+{
+	uint64_t value, shapes_count = 0, lines = 0;
+
+	if (replay->failed || replay->ended || !read_varint(replay, &value))
+	{
+		replay->failed = replay->failed || !replay->ended;
+		return false;
+	}
+
+	if ((value & REPLAY_ACTION_MASK) == REPLAY_RECORD_END)
+	{
+		replay->ended  = true;
+		replay->failed = !read_varint(replay, &shapes_count) || !read_varint(replay, &lines);
+
+		replay->shapes_count = (uint32_t)shapes_count;
+		replay->lines		 = (uint32_t)lines;
+
+		return false;
+	}
+
+	if ((value & REPLAY_ACTION_MASK) > PLAYER_ACTION_HARD_DROP)
+	{
+		replay->failed = true;
+		return false;
+	}
+
+	*action = (player_action_t)(value & REPLAY_ACTION_MASK);
+
+	if (value & REPLAY_ZERO_DELTA_TIME)
+	{
+		*delta_time_ms = 0;
+		return true;
+	}
+
+	replay->delta_time_ms += zigzag_decode(value >> REPLAY_HEADER_BITS);
+	*delta_time_ms = replay->delta_time_ms;
+
+	return true;
+}
+
+// replays the whole game headless, as fast as possible
+bool replay_play(const char *file, replay_result_t *result)
+{
+	replay_t		replay;
+	engine_t		engine;
+	player_action_t action;
+	uint32_t		delta_time_ms;
+
+	memset(result, 0, sizeof(replay_result_t));
+
+	if (!replay_open(&replay, file))
+	{
+		replay_close(&replay, NULL);
+		return false;
+	}
+
+	engine_init(&engine, replay.seed, replay.randomizer_type, replay.board_size);
+
+	while (replay_read_step(&replay, &action, &delta_time_ms))
+	{
+		engine_step(&engine, action, replay_get_delta_time(delta_time_ms));
+		result->steps++;
+		result->game_time += delta_time_ms / 1e3;
+	}
+
+	result->shapes_count = engine.shapes_count;
+	result->lines		 = engine.lines;
+	result->score		 = engine.score;
+	result->matches		 = replay.ended && replay.shapes_count == engine.shapes_count && replay.lines == engine.lines;
+
+	engine_dispose(&engine);
+	replay_close(&replay, NULL);
+
+	return !replay.failed;
+}
+
+uint32_t replay_get_delta_time_ms(float32_t delta_time)
+{
+	return delta_time > 0 ? (uint32_t)(delta_time * 1e3 + 0.5) : 0;
+}
+
+float32_t replay_get_delta_time(uint32_t delta_time_ms)
+{
+	return (float32_t)(delta_time_ms / 1e3);
+}
+
+// little endian base 128, 7 bits per byte
+static void write_varint(replay_t *replay, uint64_t value)
+{
+	uint8_t bytes[10];
+	uint8_t length = 0;
+
+	do
+	{
+		bytes[length] = value & 0x7f;
+		value >>= 7;
+		bytes[length++] |= value ? 0x80 : 0;
+	} while (value);
+
+	if (fwrite(bytes, 1, length, replay->file) != length)
+	{
+		replay->failed = true;
+	}
+}
+
+static bool read_varint(replay_t *replay, uint64_t *value)
+{
+	int ch;
+
+	*value = 0;
+
+	for (uint8_t shift = 0; shift < 64; shift += 7)
+	{
+		if ((ch = fgetc(replay->file)) == EOF)
+		{
+			return false;
+		}
+
+		*value |= (uint64_t)(ch & 0x7f) << shift;
+
+		if (!(ch & 0x80))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static uint64_t zigzag_encode(int64_t value)
+{
+	return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+static int64_t zigzag_decode(uint64_t value)
+{
+	return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "engine.h"
+
+#define REPLAY_MAGIC "TRPL"
+#define REPLAY_VERSION 3
+
+// a game as the seed, randomizer type and board size plus every engine step
+// (action and delta time). Steps are varints of (zigzag(delta time - previous
+// delta time) << 4 | zero << 3 | action), with delta times in milliseconds.
+// Steps with a zero delta time (the actions of a frame) only set the zero
+// bit, so both them and frames without input are one byte.
+// The last record (action REPLAY_RECORD_END) holds shapes and lines counts
+// to check the replayed game against.
+//
+// The engine has to be stepped with the delta times as they are stored
+// (replay_get_delta_time) for the game to be replayed exactly
+typedef struct replay_t
+{
+	FILE			 *file;
+	uint32_t		  seed;
+	randomizer_type_t randomizer_type;
+	board_size_t	  board_size;	 // the default one for version 2 replays
+	uint32_t		  delta_time_ms; // of the previous step with any
+	uint32_t		  shapes_count;	 // read from the end record
+	uint32_t		  lines;
+	bool			  ended;
+	bool			  failed; // io error or malformed file
+} replay_t;
+
+// headless replay result
+typedef struct replay_result_t
+{
+	uint32_t  steps;
+	uint32_t  shapes_count;
+	uint32_t  lines;
+	uint16_t  score;
+	float64_t game_time; // sum of the delta times
+	bool	  matches;	 // same shapes and lines as recorded
+} replay_result_t;
+
+bool	  replay_create(replay_t *replay, const char *file, uint32_t seed, randomizer_type_t randomizer_type, board_size_t board_size);
+void	  replay_record_step(replay_t *replay, player_action_t action, uint32_t delta_time_ms);
+bool	  replay_close(replay_t *replay, const engine_t *engine);
+bool	  replay_open(replay_t *replay, const char *file);
+bool	  replay_read_step(replay_t *replay, player_action_t *action, uint32_t *delta_time_ms);
+bool	  replay_play(const char *file, replay_result_t *result);
+uint32_t  replay_get_delta_time_ms(float32_t delta_time);
+float32_t replay_get_delta_time(uint32_t delta_time_ms);
+
+#endif
\ No newline at end of file
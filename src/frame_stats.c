@@ -0,0 +1,153 @@
+#include "frame_stats.h"
+#include "common.h"
+#include "data_structures/memory.h"
+
+static float32_t			budget;
+static uint32_t				buckets[FRAME_STATS_BUCKETS];
+static uint32_t				frames;
+static uint32_t				over_budget;
+static uint32_t				over_double_budget;
+static uint32_t				late;
+static float32_t			max_frame_time;
+static float32_t			max_busy_time;
+static float64_t			total_time;
+static float64_t			total_busy_time;
+static frame_stats_screen_t screens[FRAME_STATS_SCREENS];
+
+static uint8_t	 get_bucket(float32_t frame_time);
+static float64_t get_bucket_bound_ms(uint8_t bucket);
+static float64_t get_percentile_ms(float64_t percentile);
+
+// budget is the target frame time, in seconds
+void frame_stats_init(float32_t frame_budget)
+{
+	budget = frame_budget;
+}
+
+// seconds. lateness is how long after it was due the frame started, 0 for
+// frames nobody waited for (input). allocations are the heap ones of the frame
+void frame_stats_add(uint8_t screen, float32_t frame_time, float32_t busy_time, float32_t lateness, uint32_t allocations)
+{
+	ASSERT(screen < FRAME_STATS_SCREENS);
+
+	frame_stats_screen_t *totals = &screens[screen];
+
+	buckets[get_bucket(frame_time)]++;
+	frames++;
+	total_time += frame_time;
+	total_busy_time += busy_time;
+	over_budget += busy_time > budget;
+	over_double_budget += busy_time > budget * 2;
+	late += lateness > budget;
+	max_frame_time = frame_time > max_frame_time ? frame_time : max_frame_time;
+	max_busy_time  = busy_time > max_busy_time ? busy_time : max_busy_time;
+
+	totals->frames++;
+	totals->over_budget += busy_time > budget;
+	totals->late += lateness > budget;
+	totals->time += frame_time;
+	totals->busy_time += busy_time;
+	totals->allocations += allocations;
+	totals->allocating_frames += allocations > 0;
+}
+
+// screen_names holds FRAME_STATS_SCREENS names, NULL for unused indexes
+bool frame_stats_write_json(const char *file, const char *const *screen_names)
+{
+	FILE *f = fopen(file, "w");
+	bool  first;
+
+	if (!f)
+	{
+		return false;
+	}
+
+	fprintf(f, "{\n");
+	fprintf(f, "\t\"frames\": %u,\n\t\"seconds\": %.3f,\n\t\"budget_ms\": %.3f,\n", frames, total_time, budget * 1e3);
+	fprintf(f, "\t\"heap_allocations\": %lu,\n", (unsigned long)memory_get_allocations());
+	fprintf(f, "\t\"over_budget\": %u,\n\t\"over_double_budget\": %u,\n\t\"late\": %u,\n", over_budget, over_double_budget, late);
+	fprintf(f,
+			"\t\"frame_time_ms\": { \"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"p999\": %.3f, \"max\": %.3f },\n",
+			get_percentile_ms(0.5),
+			get_percentile_ms(0.9),
+			get_percentile_ms(0.99),
+			get_percentile_ms(0.999),
+			max_frame_time * 1e3);
+	fprintf(f, "\t\"busy_time_ms\": { \"mean\": %.3f, \"max\": %.3f },\n", frames ? total_busy_time * 1e3 / frames : 0, max_busy_time * 1e3);
+	fprintf(f, "\t\"histogram\": { \"first_ms\": %.3f, \"ratio\": %.6f, \"counts\": [", FRAME_STATS_FIRST_BUCKET_MS, sqrt(2));
+
+	for (uint8_t i = 0; i < FRAME_STATS_BUCKETS; i++)
+	{
+		fprintf(f, i ? ", %u" : "%u", buckets[i]);
+	}
+
+	fprintf(f, "] },\n\t\"screens\": {");
+	first = true;
+
+	for (uint8_t i = 0; i < FRAME_STATS_SCREENS; i++)
+	{
+		const frame_stats_screen_t *totals = &screens[i];
+
+		if (!screen_names[i])
+		{
+			continue;
+		}
+
+		fprintf(f,
+				"%s\n\t\t\"%s\": { \"frames\": %u, \"seconds\": %.3f, \"busy_seconds\": %.3f, \"over_budget\": %u, \"late\": %u, \"allocations\": %u, \"allocating_frames\": %u }",
+				first ? "" : ",",
+				screen_names[i],
+				totals->frames,
+				totals->time,
+				totals->busy_time,
+				totals->over_budget,
+				totals->late,
+				totals->allocations,
+				totals->allocating_frames);
+		first = false;
+	}
+
+	fprintf(f, "\n\t}\n}\n");
+
+	return fclose(f) == 0;
+}
+
+// bucket i holds times up to get_bucket_bound_ms(i)
+static uint8_t get_bucket(float32_t frame_time)
+{
+	float64_t ms = frame_time * 1e3;
+
+	if (ms <= FRAME_STATS_FIRST_BUCKET_MS)
+	{
+		return 0;
+	}
+
+	float64_t bucket = ceil(2 * log2(ms / FRAME_STATS_FIRST_BUCKET_MS));
+
+	return bucket < FRAME_STATS_BUCKETS - 1 ? (uint8_t)bucket : FRAME_STATS_BUCKETS - 1;
+}
+
+static float64_t get_bucket_bound_ms(uint8_t bucket)
+{
+	return FRAME_STATS_FIRST_BUCKET_MS * pow(2, bucket * 0.5);
+}
+
+// upper bound of the bucket holding the percentile, the max for the last one
+static float64_t get_percentile_ms(float64_t percentile)
+{
+	uint64_t count = 0;
+	uint64_t rank  = (uint64_t)ceil(frames * percentile);
+
+	for (uint8_t i = 0; i < FRAME_STATS_BUCKETS - 1 && frames; i++)
+	{
+		count += buckets[i];
+
+		if (count >= rank)
+		{
+			float64_t bound = get_bucket_bound_ms(i);
+			return bound < max_frame_time * 1e3 ? bound : max_frame_time * 1e3;
+		}
+	}
+
+	return max_frame_time * 1e3;
+}
\ No newline at end of file
@@ -0,0 +1,28 @@
+#ifndef FRAME_STATS_H
+#define FRAME_STATS_H
+
+#include "types.h"
+
+// frame times of the whole session in log buckets (each one sqrt(2) times the
+// previous, from FRAME_STATS_FIRST_BUCKET_MS, the last one open ended), so
+// memory and cost don't grow with the session
+#define FRAME_STATS_BUCKETS 40
+#define FRAME_STATS_FIRST_BUCKET_MS 0.1
+#define FRAME_STATS_SCREENS 6 // totals by screen index
+
+typedef struct frame_stats_screen_t
+{
+	uint32_t  frames;
+	uint32_t  over_budget; // busy longer than the frame budget
+	uint32_t  late;		   // woke up over a frame budget after it was due
+	uint32_t  allocations; // heap, see memory.h
+	uint32_t  allocating_frames;
+	float64_t time;
+	float64_t busy_time; // input, update and render
+} frame_stats_screen_t;
+
+void frame_stats_init(float32_t frame_budget);
+void frame_stats_add(uint8_t screen, float32_t frame_time, float32_t busy_time, float32_t lateness, uint32_t allocations);
+bool frame_stats_write_json(const char *file, const char *const *screen_names);
+
+#endif
\ No newline at end of file
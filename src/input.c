@@ -0,0 +1,282 @@
+#include "input.h"
+#include "common.h"
+
+#define INPUT_MAX_REPEATS 20 // per update, a zero arr would never end
+
+// terminals only send key presses, a held key shows up as a press followed
+// by repeats (after a delay of 0.25-0.7s, then every 30-50ms). Repeats of
+// the repeat keys are dropped and replaced by our own, das/arr paced ones.
+// The arrows unless a screen sets others
+static const int	   c_default_repeat_keys[]		  = { CH_LEFT, CH_RIGHT, CH_DOWN };
+static const float32_t c_terminal_repeat_delay_min	  = 0.2; // a bit below the shortest one
+static const float32_t c_terminal_repeat_delay_max	  = 1.0;
+static const float32_t c_terminal_repeat_interval_max = 0.1;
+
+typedef struct key_repeat_t
+{
+	float32_t pressed_time;
+	float32_t last_event_time;
+	float32_t event_interval; // between the last terminal repeats
+	float32_t next_repeat_time;
+	bool	  down;
+	bool	  held;
+	bool	  first_repeat; // the last event came a terminal delay after the press, pending until the next one
+} key_repeat_t;
+
+static input_repeat_config_t repeat_config;
+static int					 repeat_keys[INPUT_REPEAT_KEYS_CAPACITY];
+static uint8_t				 repeat_keys_count;
+static key_repeat_t			 repeats[INPUT_REPEAT_KEYS_CAPACITY];
+static int					 keys[INPUT_KEYS_CAPACITY];
+static uint8_t				 keys_count;
+
+static void		push_key(int key);
+static void		push_first_repeat(int key, key_repeat_t *repeat, float32_t time);
+static void		handle_key(int key, float32_t now);
+static void		update_repeat(int key, key_repeat_t *repeat, float32_t now);
+static int8_t	get_repeat_index(int key);
+
+void input_init(const input_repeat_config_t *config)
+{
+	repeat_config = *config;
+	keys_count	  = 0;
+	input_set_repeat_keys(NULL, 0);
+}
+
+// the keys auto repeated from now on, e.g. the versus screen adds the first
+// player's ones. NULL for the default ones
+void input_set_repeat_keys(const int *keys, uint8_t count)
+{
+	if (!keys)
+	{
+		keys  = c_default_repeat_keys;
+		count = sizeof(c_default_repeat_keys) / sizeof(c_default_repeat_keys[0]);
+	}
+
+	ASSERT(count <= INPUT_REPEAT_KEYS_CAPACITY);
+
+	memcpy(repeat_keys, keys, count * sizeof(int));
+	repeat_keys_count = count;
+	memset(repeats, 0, sizeof(repeats));
+}
+
+// reads every pending key, in order, plus the auto repeated ones
+void input_update(float32_t now)
+{
+	int		pending[INPUT_KEYS_CAPACITY];
+	uint8_t pending_count = 0;
+	int		key;
+
+	while (pending_count < INPUT_KEYS_CAPACITY && (key = getch()) != ERR)
+	{
+		pending[pending_count++] = key;
+	}
+
+	input_update_keys(pending, pending_count, now);
+}
+
+// input_update with the given keys instead of the terminal ones
+void input_update_keys(const int *pending, uint8_t pending_count, float32_t now)
+{
+	keys_count = 0;
+
+	for (uint8_t i = 0; i < pending_count; i++)
+	{
+		handle_key(pending[i], now);
+	}
+
+	for (uint8_t i = 0; i < repeat_keys_count; i++)
+	{
+		update_repeat(repeat_keys[i], &repeats[i], now);
+	}
+}
+
+uint8_t input_get_keys_count(void)
+{
+	return keys_count;
+}
+
+int input_get_key(uint8_t index)
+{
+	ASSERT(index < keys_count);
+
+	return keys[index];
+}
+
+bool input_key_pressed(int key)
+{
+	for (uint8_t i = 0; i < keys_count; i++)
+	{
+		if (keys[i] == key)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// seconds until the next auto repeat or pending first repeat, negative
+// when there is none
+float32_t input_get_next_repeat_time(float32_t now)
+{
+	float32_t next_time = -1;
+
+	for (uint8_t i = 0; i < repeat_keys_count; i++)
+	{
+		const key_repeat_t *repeat = &repeats[i];
+
+		if (!repeat->held && !repeat->first_repeat)
+		{
+			continue;
+		}
+
+		float32_t time = repeat->next_repeat_time;
+
+		// waiting for the terminal, if it doesn't repeat the key was released
+		// (or the first repeat was a press)
+		if (!repeat->held || time > repeat->last_event_time + repeat->event_interval)
+		{
+			time = repeat->last_event_time + c_terminal_repeat_interval_max;
+		}
+
+		time = time > now ? time - now : 0;
+
+		if (next_time < 0 || time < next_time)
+		{
+			next_time = time;
+		}
+	}
+
+	return next_time;
+}
+
+static void push_key(int key)
+{
+	if (keys_count < INPUT_KEYS_CAPACITY)
+	{
+		keys[keys_count++] = key;
+	}
+}
+
+// no event followed the first repeat, it was a press of its own
+static void push_first_repeat(int key, key_repeat_t *repeat, float32_t time)
+{
+	repeat->first_repeat = false;
+	repeat->pressed_time = time;
+	push_key(key);
+}
+
+static void handle_key(int key, float32_t now)
+{
+	int8_t index = get_repeat_index(key);
+
+	if (index < 0)
+	{
+		push_key(key);
+		return;
+	}
+
+	key_repeat_t *repeat   = &repeats[index];
+	float32_t	  interval = now - repeat->last_event_time;
+
+	repeat->last_event_time = now;
+
+	// terminal repeat of a held key
+	if (repeat->held)
+	{
+		repeat->event_interval = interval;
+		return;
+	}
+
+	// a terminal repeat delay after the press and then an event within a
+	// repeat interval, the key is held since it was pressed. Auto repeat
+	// starts das after the press, but not before the first terminal repeat
+	if (repeat->down && repeat->first_repeat && interval <= c_terminal_repeat_interval_max)
+	{
+		float32_t first_repeat_time = now - interval;
+
+		repeat->first_repeat	 = false;
+		repeat->held			 = true;
+		repeat->event_interval	 = interval;
+		repeat->next_repeat_time = repeat->pressed_time + repeat_config.das;
+
+		if (repeat->next_repeat_time < first_repeat_time)
+		{
+			repeat->next_repeat_time = first_repeat_time;
+		}
+
+		return;
+	}
+
+	if (repeat->first_repeat)
+	{
+		push_first_repeat(key, repeat, now - interval);
+	}
+
+	// the first terminal repeat can't be told apart from a press until the
+	// next event comes (or doesn't), so it's held back until then. Anything
+	// else (double taps included) is a press
+	bool after_press	 = repeat->down && !repeat->first_repeat;
+	repeat->first_repeat = after_press && interval >= c_terminal_repeat_delay_min && interval <= c_terminal_repeat_delay_max;
+	repeat->down		 = true;
+
+	if (!repeat->first_repeat)
+	{
+		repeat->pressed_time = now;
+		push_key(key);
+	}
+}
+
+static void update_repeat(int key, key_repeat_t *repeat, float32_t now)
+{
+	if (!repeat->down)
+	{
+		return;
+	}
+
+	if (!repeat->held)
+	{
+		if (repeat->first_repeat && now - repeat->last_event_time > c_terminal_repeat_interval_max)
+		{
+			push_first_repeat(key, repeat, repeat->last_event_time);
+		}
+
+		repeat->down = now - repeat->last_event_time <= c_terminal_repeat_delay_max;
+		return;
+	}
+
+	// released keys are only noticed when the terminal stops repeating them, so
+	// repeats never go further than one terminal interval past the last one
+	float32_t end_time = repeat->last_event_time + repeat->event_interval;
+
+	for (uint8_t i = 0; i < INPUT_MAX_REPEATS && repeat->next_repeat_time <= now && repeat->next_repeat_time <= end_time; i++)
+	{
+		push_key(key);
+		repeat->next_repeat_time += repeat_config.arr;
+	}
+
+	if (now - repeat->last_event_time > c_terminal_repeat_interval_max)
+	{
+		repeat->down = false;
+		repeat->held = false;
+	}
+	else if (repeat->next_repeat_time < now)
+	{
+		// more than INPUT_MAX_REPEATS were due
+		repeat->next_repeat_time = now;
+	}
+}
+
+static int8_t get_repeat_index(int key)
+{
+	for (uint8_t i = 0; i < repeat_keys_count; i++)
+	{
+		if (repeat_keys[i] == key)
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
\ No newline at end of file
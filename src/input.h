@@ -0,0 +1,25 @@
+#ifndef INPUT_H
+#define INPUT_H
+
+#include "defs.h"
+
+#define INPUT_KEYS_CAPACITY 64
+#define INPUT_REPEAT_KEYS_CAPACITY 8
+
+// delayed auto shift and auto repeat rate, in seconds
+typedef struct input_repeat_config_t
+{
+	float32_t das;
+	float32_t arr;
+} input_repeat_config_t;
+
+void	  input_init(const input_repeat_config_t *config);
+void	  input_set_repeat_keys(const int *keys, uint8_t count);
+void	  input_update(float32_t now);
+void	  input_update_keys(const int *pending, uint8_t pending_count, float32_t now);
+uint8_t	  input_get_keys_count(void);
+int		  input_get_key(uint8_t index);
+bool	  input_key_pressed(int key);
+float32_t input_get_next_repeat_time(float32_t now);
+
+#endif
\ No newline at end of file
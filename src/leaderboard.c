@@ -0,0 +1,638 @@
+#define _POSIX_C_SOURCE 200809L
+#include "leaderboard.h"
+#include "data_structures/memory.h"
+
+#ifdef __linux__
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define LEADERBOARD_PATH_SIZE 256
+#define LEADERBOARD_APPEND_ATTEMPTS 8 // the log can be replaced by a compaction meanwhile
+
+typedef struct log_header_t
+{
+	char	 magic[4];
+	uint32_t version;
+	uint64_t generation;
+} log_header_t;
+
+// followed by the entry numbers sorted by score, then the ones sorted by user
+typedef struct index_header_t
+{
+	char	 magic[4];
+	uint32_t version;
+	uint64_t generation; // of the log it indexes
+	uint32_t entries_count;
+	uint32_t reserved;
+} index_header_t;
+
+typedef enum index_order_t
+{
+	INDEX_ORDER_SCORE = 0,
+	INDEX_ORDER_USER  = 1
+} index_order_t;
+
+// an entry and its number, sorted to build the index
+typedef struct numbered_entry_t
+{
+	const leaderboard_entry_t *entry;
+	uint32_t				   number;
+} numbered_entry_t;
+
+static bool		get_index_file(const char *file, char *index_file);
+static bool		lock_file(FILE *f, bool exclusive);
+static void		unlock_file(FILE *f);
+static bool		is_current_file(FILE *f, const char *file);
+static bool		sync_file(FILE *f);
+static bool		read_entry(const leaderboard_t *board, uint32_t number, leaderboard_entry_t *entry);
+static uint32_t read_index(const leaderboard_t *board, index_order_t order, uint32_t position);
+static void		insert_entry(leaderboard_entry_t *entries, uint32_t *found, uint32_t count, const leaderboard_entry_t *entry);
+static int		compare_entries(const leaderboard_entry_t *a, const leaderboard_entry_t *b);
+static int		compare_by_score(const void *a, const void *b);
+static int		compare_by_user(const void *a, const void *b);
+static bool		is_duplicate(const numbered_entry_t *sorted, uint32_t count, const leaderboard_entry_t *entry);
+static bool		write_compacted(const char *file, const char *index_file, uint64_t generation, numbered_entry_t *sorted, uint32_t count);
+#ifdef __linux__
+static void sync_dir(const char *file);
+#endif
+
+// locks the log and appends at its end, also after a compaction replaced it
+bool leaderboard_append(const char *file, const leaderboard_entry_t *entry)
+{
+	log_header_t header = { .version = LEADERBOARD_VERSION };
+
+	memcpy(header.magic, LEADERBOARD_MAGIC, sizeof(header.magic));
+
+	for (uint8_t attempt = 0; attempt < LEADERBOARD_APPEND_ATTEMPTS; attempt++)
+	{
+		FILE *log = fopen(file, "ab");
+
+		if (!log || !lock_file(log, true))
+		{
+			if (log)
+			{
+				fclose(log);
+			}
+
+			return false;
+		}
+
+		if (!is_current_file(log, file))
+		{
+			unlock_file(log);
+			fclose(log);
+			continue;
+		}
+
+		fseek(log, 0, SEEK_END);
+		long size	 = ftell(log);
+		bool written = true;
+
+#ifdef __linux__
+		// a partial entry (or header) left by a crash is dropped
+		long partial = size < (long)sizeof(log_header_t) ? size : (size - (long)sizeof(log_header_t)) % (long)sizeof(leaderboard_entry_t);
+
+		if (partial > 0)
+		{
+			written = ftruncate(fileno(log), size - partial) == 0;
+			size -= partial;
+		}
+#endif
+
+		if (size == 0)
+		{
+			written = written && fwrite(&header, sizeof(header), 1, log) == 1;
+		}
+
+		written = written && fwrite(entry, sizeof(leaderboard_entry_t), 1, log) == 1 && sync_file(log);
+
+#ifdef __linux__
+		// a new log is only on disk once its directory is
+		if (size == 0)
+		{
+			sync_dir(file);
+		}
+#endif
+
+		unlock_file(log);
+		written = fclose(log) == 0 && written;
+
+		return written;
+	}
+
+	return false;
+}
+
+// false only for files that aren't a leaderboard, a missing log is empty
+bool leaderboard_open(leaderboard_t *board, const char *file)
+{
+	char		   index_file[LEADERBOARD_PATH_SIZE];
+	log_header_t   header;
+	index_header_t index_header;
+	long		   size;
+
+	memset(board, 0, sizeof(leaderboard_t));
+
+	if (!get_index_file(file, index_file))
+	{
+		return false;
+	}
+
+	if (!(board->log = fopen(file, "rb")))
+	{
+		return true;
+	}
+
+	// the header and size are read together, never halfway through an append
+	lock_file(board->log, false);
+	bool valid = fread(&header, sizeof(header), 1, board->log) == 1 &&
+				 memcmp(header.magic, LEADERBOARD_MAGIC, sizeof(header.magic)) == 0 &&
+				 header.version == LEADERBOARD_VERSION;
+	fseek(board->log, 0, SEEK_END);
+	size = ftell(board->log);
+	unlock_file(board->log);
+
+	if (!valid)
+	{
+		leaderboard_close(board);
+		return size == 0;
+	}
+
+	board->generation	 = header.generation;
+	board->entries_count = (size - sizeof(log_header_t)) / sizeof(leaderboard_entry_t);
+	board->index		 = fopen(index_file, "rb");
+
+	if (board->index &&
+		fread(&index_header, sizeof(index_header), 1, board->index) == 1 &&
+		memcmp(index_header.magic, LEADERBOARD_INDEX_MAGIC, sizeof(index_header.magic)) == 0 &&
+		index_header.version == LEADERBOARD_VERSION &&
+		index_header.generation == board->generation &&
+		index_header.entries_count <= board->entries_count)
+	{
+		board->indexed_count = index_header.entries_count;
+	}
+	else if (board->index)
+	{
+		fclose(board->index);
+		board->index = NULL;
+	}
+
+	return true;
+}
+
+void leaderboard_close(leaderboard_t *board)
+{
+	if (board->log)
+	{
+		fclose(board->log);
+	}
+
+	if (board->index)
+	{
+		fclose(board->index);
+	}
+
+	memset(board, 0, sizeof(leaderboard_t));
+}
+
+// best entries first, returns how many were found (up to count)
+uint32_t leaderboard_get_top(const leaderboard_t *board, leaderboard_entry_t *entries, uint32_t count)
+{
+	leaderboard_entry_t entry;
+	uint32_t			found = 0;
+
+	for (uint32_t i = 0; i < board->indexed_count && i < count; i++)
+	{
+		if (read_entry(board, read_index(board, INDEX_ORDER_SCORE, i), &entry))
+		{
+			insert_entry(entries, &found, count, &entry);
+		}
+	}
+
+	for (uint32_t number = board->indexed_count; number < board->entries_count; number++)
+	{
+		if (read_entry(board, number, &entry))
+		{
+			insert_entry(entries, &found, count, &entry);
+		}
+	}
+
+	return found;
+}
+
+// best entries of the user first, returns how many were found (up to count)
+uint32_t leaderboard_get_user_top(const leaderboard_t *board, const char *user, leaderboard_entry_t *entries, uint32_t count)
+{
+	leaderboard_entry_t entry;
+	uint32_t			found = 0;
+	uint32_t			low	  = 0;
+	uint32_t			high  = board->indexed_count;
+
+	// first indexed entry of the user, the rest follow by score
+	while (low < high)
+	{
+		uint32_t middle = low + ((high - low) / 2);
+
+		if (read_entry(board, read_index(board, INDEX_ORDER_USER, middle), &entry) &&
+			strncmp(entry.user, user, LEADERBOARD_USER_SIZE) < 0)
+		{
+			low = middle + 1;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+
+	for (uint32_t i = low; i < board->indexed_count && found < count; i++)
+	{
+		if (!read_entry(board, read_index(board, INDEX_ORDER_USER, i), &entry) ||
+			strncmp(entry.user, user, LEADERBOARD_USER_SIZE) != 0)
+		{
+			break;
+		}
+
+		insert_entry(entries, &found, count, &entry);
+	}
+
+	for (uint32_t number = board->indexed_count; number < board->entries_count; number++)
+	{
+		if (read_entry(board, number, &entry) && strncmp(entry.user, user, LEADERBOARD_USER_SIZE) == 0)
+		{
+			insert_entry(entries, &found, count, &entry);
+		}
+	}
+
+	return found;
+}
+
+bool leaderboard_needs_compaction(const leaderboard_t *board)
+{
+	return board->entries_count - board->indexed_count > LEADERBOARD_TAIL_MAX;
+}
+
+// rewrites the log and its index while holding the log's lock, appends
+// waiting on it go to the new log once it's renamed over the old one
+bool leaderboard_compact(const char *file)
+{
+	char				 index_file[LEADERBOARD_PATH_SIZE];
+	log_header_t		 header;
+	leaderboard_entry_t *entries = NULL;
+	numbered_entry_t	*sorted	 = NULL;
+	uint32_t			 count	 = 0;
+	uint32_t			 kept	 = 0;
+	FILE				*log;
+
+	if (!get_index_file(file, index_file))
+	{
+		return false;
+	}
+
+	if (!(log = fopen(file, "r+b")))
+	{
+		return true;
+	}
+
+	if (!lock_file(log, true))
+	{
+		fclose(log);
+		return false;
+	}
+
+	// already compacted by another process while waiting for the lock
+	if (!is_current_file(log, file))
+	{
+		unlock_file(log);
+		fclose(log);
+		return true;
+	}
+
+	bool compacted = fread(&header, sizeof(header), 1, log) == 1 &&
+					 memcmp(header.magic, LEADERBOARD_MAGIC, sizeof(header.magic)) == 0 &&
+					 header.version == LEADERBOARD_VERSION &&
+					 fseek(log, 0, SEEK_END) == 0;
+
+	if (compacted)
+	{
+		count	= (ftell(log) - sizeof(log_header_t)) / sizeof(leaderboard_entry_t);
+		entries = (leaderboard_entry_t *)memory_alloc((count + 1) * sizeof(leaderboard_entry_t));
+		sorted	= (numbered_entry_t *)memory_alloc((count + 1) * sizeof(numbered_entry_t));
+
+		compacted = entries && sorted &&
+					fseek(log, sizeof(log_header_t), SEEK_SET) == 0 &&
+					fread(entries, sizeof(leaderboard_entry_t), count, log) == count;
+	}
+
+	if (compacted)
+	{
+		for (uint32_t i = 0; i < count; i++)
+		{
+			entries[i].user[LEADERBOARD_USER_SIZE - 1] = '\0';
+			sorted[i]								   = (numbered_entry_t){ .entry = &entries[i], .number = i };
+		}
+
+		qsort(sorted, count, sizeof(numbered_entry_t), compare_by_user);
+
+		// every entry in user order, numbered as they'll be in the new log.
+		// Torn ones (never written before a crash, zeroed and without a user)
+		// and the same entry appended twice are dropped
+		for (uint32_t i = 0; i < count; i++)
+		{
+			if (sorted[i].entry->user[0] != '\0' && !is_duplicate(sorted, kept, sorted[i].entry))
+			{
+				sorted[kept++] = sorted[i];
+			}
+		}
+
+		for (uint32_t i = 0; i < kept; i++)
+		{
+			sorted[i].number = i;
+		}
+
+		compacted = write_compacted(file, index_file, header.generation + 1, sorted, kept);
+	}
+
+	memory_free(sorted);
+	memory_free(entries);
+	unlock_file(log);
+	fclose(log);
+
+	return compacted;
+}
+
+static bool get_index_file(const char *file, char *index_file)
+{
+	return snprintf(index_file, LEADERBOARD_PATH_SIZE, "%s.idx", file) < LEADERBOARD_PATH_SIZE;
+}
+
+// whole file record locks, waiting for them. There's no locking where
+// fcntl isn't available
+static bool lock_file(FILE *f, bool exclusive)
+{
+#ifdef __linux__
+	struct flock lock = { .l_type = exclusive ? F_WRLCK : F_RDLCK, .l_whence = SEEK_SET, .l_start = 0, .l_len = 0 };
+
+	while (fcntl(fileno(f), F_SETLKW, &lock) != 0)
+	{
+		if (errno != EINTR)
+		{
+			return false;
+		}
+	}
+#else
+	(void)f;
+	(void)exclusive;
+#endif
+
+	return true;
+}
+
+static void unlock_file(FILE *f)
+{
+#ifdef __linux__
+	struct flock lock = { .l_type = F_UNLCK, .l_whence = SEEK_SET, .l_start = 0, .l_len = 0 };
+
+	fflush(f);
+	fcntl(fileno(f), F_SETLK, &lock);
+#else
+	(void)f;
+#endif
+}
+
+// false when the file was replaced (renamed over) since it was opened
+static bool is_current_file(FILE *f, const char *file)
+{
+#ifdef __linux__
+	struct stat opened, current;
+
+	return fstat(fileno(f), &opened) == 0 &&
+		   stat(file, &current) == 0 &&
+		   opened.st_dev == current.st_dev &&
+		   opened.st_ino == current.st_ino;
+#else
+	(void)f;
+	(void)file;
+
+	return true;
+#endif
+}
+
+static bool sync_file(FILE *f)
+{
+	if (fflush(f) != 0)
+	{
+		return false;
+	}
+
+#ifdef __linux__
+	return fsync(fileno(f)) == 0;
+#else
+	return true;
+#endif
+}
+
+static bool read_entry(const leaderboard_t *board, uint32_t number, leaderboard_entry_t *entry)
+{
+	if (number >= board->entries_count ||
+		fseek(board->log, sizeof(log_header_t) + ((long)number * sizeof(leaderboard_entry_t)), SEEK_SET) != 0 ||
+		fread(entry, sizeof(leaderboard_entry_t), 1, board->log) != 1)
+	{
+		return false;
+	}
+
+	entry->user[LEADERBOARD_USER_SIZE - 1] = '\0';
+
+	return true;
+}
+
+// entry number at the position of the order, out of range ones on errors
+static uint32_t read_index(const leaderboard_t *board, index_order_t order, uint32_t position)
+{
+	uint32_t number = UINT32_MAX;
+	long	 offset = sizeof(index_header_t) + (((long)order * board->indexed_count) + position) * sizeof(uint32_t);
+
+	if (fseek(board->index, offset, SEEK_SET) != 0 || fread(&number, sizeof(number), 1, board->index) != 1)
+	{
+		return UINT32_MAX;
+	}
+
+	return number;
+}
+
+// keeps the best count entries found so far, in order
+static void insert_entry(leaderboard_entry_t *entries, uint32_t *found, uint32_t count, const leaderboard_entry_t *entry)
+{
+	uint32_t position = *found < count ? *found : count - 1;
+
+	if (count == 0 || (*found == count && compare_entries(entry, &entries[count - 1]) >= 0))
+	{
+		return;
+	}
+
+	for (; position > 0 && compare_entries(entry, &entries[position - 1]) < 0; position--)
+	{
+		entries[position] = entries[position - 1];
+	}
+
+	entries[position] = *entry;
+	*found += *found < count;
+}
+
+// higher score, then more lines, then the oldest game first
+static int compare_entries(const leaderboard_entry_t *a, const leaderboard_entry_t *b)
+{
+	if (a->score != b->score)
+	{
+		return a->score > b->score ? -1 : 1;
+	}
+
+	if (a->lines != b->lines)
+	{
+		return a->lines > b->lines ? -1 : 1;
+	}
+
+	return (a->time > b->time) - (a->time < b->time);
+}
+
+static int compare_by_score(const void *a, const void *b)
+{
+	const numbered_entry_t *entry_a = (const numbered_entry_t *)a;
+	const numbered_entry_t *entry_b = (const numbered_entry_t *)b;
+	int						result	= compare_entries(entry_a->entry, entry_b->entry);
+
+	return result ? result : (entry_a->number > entry_b->number) - (entry_a->number < entry_b->number);
+}
+
+static int compare_by_user(const void *a, const void *b)
+{
+	const numbered_entry_t *entry_a = (const numbered_entry_t *)a;
+	const numbered_entry_t *entry_b = (const numbered_entry_t *)b;
+	int						result	= strcmp(entry_a->entry->user, entry_b->entry->user);
+
+	return result ? result : compare_by_score(a, b);
+}
+
+// among the first count sorted entries, which end with the ones tied with
+// entry (equal entries sort next to each other)
+static bool is_duplicate(const numbered_entry_t *sorted, uint32_t count, const leaderboard_entry_t *entry)
+{
+	for (uint32_t i = count; i-- > 0;)
+	{
+		const leaderboard_entry_t *other = sorted[i].entry;
+
+		if (strcmp(other->user, entry->user) != 0 || compare_entries(other, entry) != 0)
+		{
+			return false;
+		}
+
+		if (memcmp(other, entry, sizeof(leaderboard_entry_t)) == 0)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// entries in user order, so the new log is its own user index. Both files
+// are written aside and renamed in place, the index first: a reader in
+// between sees an index of another generation and ignores it
+static bool write_compacted(const char *file, const char *index_file, uint64_t generation, numbered_entry_t *sorted, uint32_t count)
+{
+	char		   temp_file[LEADERBOARD_PATH_SIZE + 4];
+	char		   temp_index_file[LEADERBOARD_PATH_SIZE + 4];
+	log_header_t   header		= { .version = LEADERBOARD_VERSION, .generation = generation };
+	index_header_t index_header = { .version = LEADERBOARD_VERSION, .generation = generation, .entries_count = count };
+
+	memcpy(header.magic, LEADERBOARD_MAGIC, sizeof(header.magic));
+	memcpy(index_header.magic, LEADERBOARD_INDEX_MAGIC, sizeof(index_header.magic));
+	snprintf(temp_file, sizeof(temp_file), "%s.tmp", file);
+	snprintf(temp_index_file, sizeof(temp_index_file), "%s.tmp", index_file);
+
+	FILE *log	  = fopen(temp_file, "wb");
+	FILE *index	  = fopen(temp_index_file, "wb");
+	bool  written = log && index;
+
+	written = written && fwrite(&header, sizeof(header), 1, log) == 1;
+	written = written && fwrite(&index_header, sizeof(index_header), 1, index) == 1;
+
+	for (uint32_t i = 0; written && i < count; i++)
+	{
+		written = fwrite(sorted[i].entry, sizeof(leaderboard_entry_t), 1, log) == 1;
+	}
+
+	if (written)
+	{
+		qsort(sorted, count, sizeof(numbered_entry_t), compare_by_score);
+	}
+
+	for (uint32_t i = 0; written && i < count; i++)
+	{
+		written = fwrite(&sorted[i].number, sizeof(uint32_t), 1, index) == 1;
+	}
+
+	for (uint32_t i = 0; written && i < count; i++)
+	{
+		written = fwrite(&i, sizeof(uint32_t), 1, index) == 1;
+	}
+
+	written = written && sync_file(log) && sync_file(index);
+	written = (!log || fclose(log) == 0) && written;
+	written = (!index || fclose(index) == 0) && written;
+
+#ifndef __linux__
+	// rename doesn't replace existing files there
+	if (written)
+	{
+		remove(index_file);
+		remove(file);
+	}
+#endif
+
+	written = written && rename(temp_index_file, index_file) == 0 && rename(temp_file, file) == 0;
+
+	if (!written)
+	{
+		remove(temp_file);
+		remove(temp_index_file);
+	}
+#ifdef __linux__
+	else
+	{
+		sync_dir(file);
+	}
+#endif
+
+	return written;
+}
+
+#ifdef __linux__
+// best effort, not every file system can sync directories
+static void sync_dir(const char *file)
+{
+	char  dir[LEADERBOARD_PATH_SIZE];
+	char *slash;
+	int	  fd;
+
+	snprintf(dir, sizeof(dir), "%s", file);
+	slash = strrchr(dir, '/');
+
+	if (!slash)
+	{
+		memcpy(dir, ".", 2);
+	}
+	else
+	{
+		*(slash == dir ? slash + 1 : slash) = '\0';
+	}
+
+	if ((fd = open(dir, O_RDONLY)) >= 0)
+	{
+		fsync(fd);
+		close(fd);
+	}
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,49 @@
+#ifndef LEADERBOARD_H
+#define LEADERBOARD_H
+
+#include "types.h"
+
+// games of every player on the host, shared by concurrent processes.
+//
+// <file> is an append-only log, a header and fixed size entries appended
+// under an exclusive record lock. <file>.idx indexes the log up to where it
+// was at the last compaction: entry numbers sorted by score, and by user
+// then score. Queries are a binary search there plus a scan of the entries
+// appended since (the tail), which compaction keeps short. It rewrites both
+// files with every game, dropping only torn and duplicate entries, with a
+// new generation so readers can tell an index of another log apart
+#define LEADERBOARD_MAGIC "TLBD"
+#define LEADERBOARD_INDEX_MAGIC "TLBI"
+#define LEADERBOARD_VERSION 1
+#define LEADERBOARD_USER_SIZE 32
+#define LEADERBOARD_TAIL_MAX 64 // unindexed entries before a compaction is due
+
+typedef struct leaderboard_entry_t
+{
+	char	 user[LEADERBOARD_USER_SIZE]; // null terminated
+	uint32_t score;
+	uint32_t lines;
+	uint32_t duration_ms;
+	uint32_t seed;
+	int64_t	 time; // when it was played, unix seconds
+} leaderboard_entry_t;
+
+// the files as they were when opened, entries appended later aren't seen
+typedef struct leaderboard_t
+{
+	FILE	*log;	// NULL when there's no log yet
+	FILE	*index; // NULL when missing or stale, the whole log is the tail then
+	uint64_t generation;
+	uint32_t entries_count;
+	uint32_t indexed_count;
+} leaderboard_t;
+
+bool	 leaderboard_append(const char *file, const leaderboard_entry_t *entry);
+bool	 leaderboard_open(leaderboard_t *board, const char *file);
+void	 leaderboard_close(leaderboard_t *board);
+uint32_t leaderboard_get_top(const leaderboard_t *board, leaderboard_entry_t *entries, uint32_t count);
+uint32_t leaderboard_get_user_top(const leaderboard_t *board, const char *user, leaderboard_entry_t *entries, uint32_t count);
+bool	 leaderboard_needs_compaction(const leaderboard_t *board);
+bool	 leaderboard_compact(const char *file);
+
+#endif
\ No newline at end of file
@@ -1,76 +1,388 @@
 #define _POSIX_C_SOURCE 199309L
+#include "assets.h"
+#include "broadcast.h"
 #include "common.h"
+#include "data_structures/arena.h"
 #include "defs.h"
+#include "engine/replay.h"
+#include "frame_stats.h"
+#include "input.h"
+#include "profile.h"
+#include "score_store.h"
 #include "screens/screens.h"
 
+#ifdef __linux__
+#include <poll.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#endif
+
 #define TERMINAL_COLS 100
 #define TERMINAL_ROWS 50
 
-#define FILE_SPLASH "assets/splash.txt"
-#define FILE_GAME_OVER "assets/game_over.txt"
+#define FILE_ASSETS "assets/assets.pack"
+#define LEADERBOARD_SHOWN 10
 
 typedef enum screen_t
 {
 	SCREEN_INIT		 = 1,
 	SCREEN_STAGE	 = 2,
-	SCREEN_GAME_OVER = 3
+	SCREEN_GAME_OVER = 3,
+	SCREEN_WATCH	 = 4, // the only one when watching
+	SCREEN_VERSUS	 = 5, // the only one in versus mode, again for a rematch
+	SCREEN_COUNT	 = 6
 } screen_t;
 
 typedef void (*screen_action_t)(void);
 typedef bool (*screen_is_completed_t)(void);
+typedef float32_t (*screen_next_wakeup_t)(void);
+typedef int (*screen_wait_fd_t)(void);
+
+// screen registry entry. Windows and buffers are created the first time the
+// screen is entered and kept until the session ends, so entering it again
+// (e.g. restarting from game over) only resets its state
+typedef struct screen_entry_t
+{
+	screen_action_t		  create;
+	screen_action_t		  destroy;
+	screen_action_t		  init; // every time it's entered
+	screen_action_t		  dispose;
+	screen_action_t		  update;
+	screen_action_t		  render;
+	screen_action_t		  window_resized;
+	screen_is_completed_t is_completed;
+	screen_next_wakeup_t  next_wakeup;
+	screen_wait_fd_t	  wait_fd; // optional, readable when the screen needs a frame
+} screen_entry_t;
 
 // #GLOBAL VARIABLES
-bool	  g_running = true;
-int		  g_key;
-float32_t g_delta_time		= 0;
-char	 *g_asset_splash	= NULL;
-char	 *g_asset_game_over = NULL;
-score_t	  g_score			= { .current = 0 };
+bool		   g_running		 = true;
+bool		   g_bot			 = false;
+bool		   g_bag			 = false;
+char		  *g_record_file	 = NULL;
+char		  *g_watch_path		 = NULL; // spectator mode (--watch)
+board_size_t   g_board_size		 = BOARD_SIZE_DEFAULT;
+float32_t	   g_delta_time		 = 0;
+const asset_t *g_asset_splash	 = NULL;
+const asset_t *g_asset_game_over = NULL;
+score_t		   g_score			 = { .current = 0 };
+arena_t		   g_screens_arena; // screens' buffers, created once for the session
 
 static const float32_t c_target_frame_time = 1.0 / 20.0; // 20 FPS
-
-static screen_action_t		 screen_action_init			  = NULL;
-static screen_action_t		 screen_action_dispose		  = NULL;
-static screen_action_t		 screen_action_update		  = NULL;
-static screen_action_t		 screen_action_render		  = NULL;
-static screen_is_completed_t screen_is_completed		  = NULL;
-static screen_action_t		 screen_action_window_resized = NULL;
-static screen_t				 current_screen				  = 0;
-
-static float32_t last_update_time = 0.0;
-
-static void		 init(void);
-static void		 dispose(void);
-static void		 load_assets(void);
-static void		 load_asset(const char *file, char **dest);
-static void		 load_score(void);
-static void		 update_state(void);
-static void		 loop(void);
-static float32_t get_current_time(void);
+static const float32_t c_max_delta_time	   = 1.0;		 // after long waits, e.g. paused
+static const float32_t c_default_das	   = 0.167;
+static const float32_t c_default_arr	   = 0.033;
+static const size_t	   c_arena_block_size  = 16 * 1024;
+
+static const char *c_screen_names[FRAME_STATS_SCREENS] = { NULL, "init", "stage", "game_over", "watch", "versus" };
+
+static const screen_entry_t c_screens[SCREEN_COUNT] = {
+	[SCREEN_INIT] = {
+		.create			= &screen_init_create,
+		.destroy		= &screen_init_destroy,
+		.init			= &screen_init_init,
+		.dispose		= &screen_init_dispose,
+		.update			= &screen_init_update,
+		.render			= &screen_init_render,
+		.window_resized = &screen_init_window_resized,
+		.is_completed	= &screen_init_is_completed,
+		.next_wakeup	= &screen_init_next_wakeup,
+	},
+	[SCREEN_STAGE] = {
+		.create			= &screen_stage_create,
+		.destroy		= &screen_stage_destroy,
+		.init			= &screen_stage_init,
+		.dispose		= &screen_stage_dispose,
+		.update			= &screen_stage_update,
+		.render			= &screen_stage_render,
+		.window_resized = &screen_stage_window_resized,
+		.is_completed	= &screen_stage_is_completed,
+		.next_wakeup	= &screen_stage_next_wakeup,
+	},
+	[SCREEN_GAME_OVER] = {
+		.create			= &screen_game_over_create,
+		.destroy		= &screen_game_over_destroy,
+		.init			= &screen_game_over_init,
+		.dispose		= &screen_game_over_dispose,
+		.update			= &screen_game_over_update,
+		.render			= &screen_game_over_render,
+		.window_resized = &screen_game_over_window_resized,
+		.is_completed	= &screen_game_over_is_completed,
+		.next_wakeup	= &screen_game_over_next_wakeup,
+	},
+	[SCREEN_WATCH] = {
+		.create			= &screen_watch_create,
+		.destroy		= &screen_watch_destroy,
+		.init			= &screen_watch_init,
+		.dispose		= &screen_watch_dispose,
+		.update			= &screen_watch_update,
+		.render			= &screen_watch_render,
+		.window_resized = &screen_watch_window_resized,
+		.is_completed	= &screen_watch_is_completed,
+		.next_wakeup	= &screen_watch_next_wakeup,
+		.wait_fd		= &screen_watch_get_wait_fd,
+	},
+	[SCREEN_VERSUS] = {
+		.create			= &screen_versus_create,
+		.destroy		= &screen_versus_destroy,
+		.init			= &screen_versus_init,
+		.dispose		= &screen_versus_dispose,
+		.update			= &screen_versus_update,
+		.render			= &screen_versus_render,
+		.window_resized = &screen_versus_window_resized,
+		.is_completed	= &screen_versus_is_completed,
+		.next_wakeup	= &screen_versus_next_wakeup,
+	},
+};
+
+static const screen_entry_t *screen			= NULL;
+static screen_t				 current_screen = 0;
+static bool					 screens_created[SCREEN_COUNT];
+
+static float32_t	last_update_time = 0.0;
+static const char  *frame_stats_file = FILE_FRAME_STATS;
+static const char  *user			 = NULL; // --user, otherwise the login name
+static const char  *broadcast_path	 = NULL;
+static bool			versus			 = false; // two players, see versus.h
+#ifdef __linux__
+static int timer_fd = -1;
+#endif
+
+static void		   parse_args(int argc, char *argv[], input_repeat_config_t *repeat_config);
+static int		   play_replay(const char *file);
+static int		   print_leaderboard(const char *leaderboard_user);
+static void		   print_entries(const char *title, const leaderboard_entry_t *entries, uint32_t count);
+static const char *get_user(void);
+static void		   init(const input_repeat_config_t *repeat_config);
+static void		   dispose(void);
+static void		   load_assets(void);
+static void		   load_asset(const char *name, const asset_t **dest);
+static void		   load_score(void);
+static void		   update_state(void);
+static void		   enter_screen(screen_t next);
+static void		   destroy_screens(void);
+static void		   loop(void);
+static float32_t   get_wait_time(void);
+static void		   wait_events(float32_t timeout);
+static float32_t   get_current_time(void);
 
 int main(int argc, char *argv[])
 {
-	(void)argc;
-	(void)argv;
+	input_repeat_config_t repeat_config = { .das = c_default_das, .arr = c_default_arr };
+
+	// headless, without a terminal
+	if (argc == 3 && strcmp(argv[1], "--replay") == 0)
+	{
+		return play_replay(argv[2]);
+	}
+
+	if ((argc == 2 || argc == 3) && strcmp(argv[1], "--leaderboard") == 0)
+	{
+		return print_leaderboard(argc == 3 ? argv[2] : get_user());
+	}
 
-	init();
+	parse_args(argc, argv, &repeat_config);
+	init(&repeat_config);
 	loop();
 	dispose();
 
 	return 0;
 }
 
-static void init(void)
+// --bot, --record <file>, --user <name>, --das and --arr (both in milliseconds).
+// --board <cols>x<rows> for other board sizes (e.g. 10x40). --broadcast and
+// --watch take an optional socket path. --versus is a match of two players on
+// the same keyboard
+static void parse_args(int argc, char *argv[], input_repeat_config_t *repeat_config)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		char	 *end	  = NULL;
+		float32_t *option = NULL;
+
+		if (strcmp(argv[i], "--bot") == 0)
+		{
+			g_bot = true;
+			continue;
+		}
+		else if (strcmp(argv[i], "--bag") == 0)
+		{
+			g_bag = true;
+			continue;
+		}
+		else if (strcmp(argv[i], "--versus") == 0)
+		{
+			versus = true;
+			continue;
+		}
+		else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+		{
+			g_record_file = argv[++i];
+			continue;
+		}
+		else if (strcmp(argv[i], "--board") == 0 && i + 1 < argc && engine_parse_board_size(argv[i + 1], &g_board_size))
+		{
+			i++;
+			continue;
+		}
+		else if (strcmp(argv[i], "--user") == 0 && i + 1 < argc)
+		{
+			user = argv[++i];
+			continue;
+		}
+		else if (strcmp(argv[i], "--frame-stats") == 0 && i + 1 < argc)
+		{
+			frame_stats_file = argv[++i];
+			continue;
+		}
+		else if (strcmp(argv[i], "--broadcast") == 0)
+		{
+			broadcast_path = i + 1 < argc && argv[i + 1][0] != '-' ? argv[++i] : FILE_BROADCAST;
+			continue;
+		}
+		else if (strcmp(argv[i], "--watch") == 0)
+		{
+			g_watch_path = i + 1 < argc && argv[i + 1][0] != '-' ? argv[++i] : FILE_BROADCAST;
+			continue;
+		}
+		else if (strcmp(argv[i], "--das") == 0)
+		{
+			option = &repeat_config->das;
+		}
+		else if (strcmp(argv[i], "--arr") == 0)
+		{
+			option = &repeat_config->arr;
+		}
+
+		if (option && i + 1 < argc)
+		{
+			long ms = strtol(argv[++i], &end, 10);
+
+			if (*end == '\0' && ms >= 0 && ms <= 1000)
+			{
+				*option = ms / 1000.0;
+				continue;
+			}
+		}
+
+		fprintf(stderr,
+				"usage: %s [--bot] [--bag] [--board <cols>x<rows>] [--record <file>] [--user <name>] [--frame-stats <file>] [--das <0-1000 ms>] [--arr <0-1000 ms>] [--broadcast [socket]]\n"
+				"       %s --versus [--bag] [--board <cols>x<rows>] [--das <0-1000 ms>] [--arr <0-1000 ms>]\n"
+				"       %s --watch [socket]\n"
+				"       %s --replay <file>\n"
+				"       %s --leaderboard [user]\n",
+				argv[0],
+				argv[0],
+				argv[0],
+				argv[0],
+				argv[0]);
+		exit(1);
+	}
+}
+
+static int play_replay(const char *file)
+{
+	replay_result_t result;
+	struct timespec start, end;
+
+	// get_current_time is too coarse for a replay that takes microseconds
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	bool played = replay_play(file, &result);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	float64_t time = (end.tv_sec - start.tv_sec) + ((end.tv_nsec - start.tv_nsec) / 1e9);
+
+	if (!played && result.steps == 0)
+	{
+		fprintf(stderr, "%s: not a replay or can't be read\n", file);
+		return 1;
+	}
+
+	printf("shapes %u, lines %u, score %u, %.1fs of game\n", result.shapes_count, result.lines, result.score, result.game_time);
+	printf("%u steps replayed in %.6fs (%.0f ns/step)\n", result.steps, time, (time * 1e9) / (result.steps ? result.steps : 1));
+	printf("%s\n", !played ? "truncated replay" : result.matches ? "matches the recorded game" : "DOESN'T match the recorded game");
+
+	return played && result.matches ? 0 : 1;
+}
+
+// best games of everyone and of the user, headless
+static int print_leaderboard(const char *leaderboard_user)
+{
+	leaderboard_t		board;
+	leaderboard_entry_t entries[LEADERBOARD_SHOWN];
+
+	if (!leaderboard_open(&board, FILE_SCORE))
+	{
+		fprintf(stderr, "%s: not a leaderboard\n", FILE_SCORE);
+		return 1;
+	}
+
+	print_entries("top", entries, leaderboard_get_top(&board, entries, LEADERBOARD_SHOWN));
+	printf("\n");
+	print_entries(leaderboard_user, entries, leaderboard_get_user_top(&board, leaderboard_user, entries, LEADERBOARD_SHOWN));
+	leaderboard_close(&board);
+
+	return 0;
+}
+
+static void print_entries(const char *title, const leaderboard_entry_t *entries, uint32_t count)
+{
+	char date[32];
+
+	printf("%s\n", title);
+
+	if (count == 0)
+	{
+		printf("  no games yet\n");
+	}
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		const leaderboard_entry_t *entry = &entries[i];
+		time_t					   time	 = (time_t)entry->time;
+
+		strftime(date, sizeof(date), "%Y-%m-%d %H:%M", localtime(&time));
+		printf("%3u. %-16s %6u points %5u lines %6.1fs  %s  seed %u\n", i + 1, entry->user, entry->score, entry->lines, entry->duration_ms / 1e3, date, entry->seed);
+	}
+}
+
+// the user name games are saved under
+static const char *get_user(void)
 {
+	const char *name = user ? user : getenv("USER");
+
+	name = name && *name ? name : getenv("LOGNAME");
+
+	return name && *name ? name : "player";
+}
+
+static void init(const input_repeat_config_t *repeat_config)
+{
+	g_screens_arena = arena_new(c_arena_block_size);
 	load_assets();
-	load_score();
+
+	// watchers don't play, versus matches and games on other board sizes
+	// aren't on the leaderboard (their scores don't compare), nothing is saved
+	if (!g_watch_path && !versus && g_board_size.rows == BOARD_ROWS_DEFAULT && g_board_size.cols == BOARD_COLS_DEFAULT)
+	{
+		load_score();
+	}
+
+	if (broadcast_path && !broadcast_init(broadcast_path, get_user()))
+	{
+		fprintf(stderr, "%s\n", broadcast_get_error());
+		exit(1);
+	}
+
 	initscr();
 	cbreak();
 	noecho();
 	curs_set(0);
+	render_init(render_curses_get_backend());
 	nodelay(stdscr, TRUE);
 	keypad(stdscr, TRUE);
-	// timeout(10);
+	input_init(repeat_config);
+	frame_stats_init(c_target_frame_time);
 	resize_term(TERMINAL_ROWS, TERMINAL_COLS);
 	start_color();
 
@@ -158,22 +470,35 @@ static void init(void)
 	init_pair(COLOR_PAIR_RED_BK, CUSTOM_COLOR_WHITE_DEFAULT, CUSTOM_COLOR_RED_DEFAULT);
 
 	refresh();
+
+#ifdef __linux__
+	timer_fd = timerfd_create(CLOCK_MONOTONIC, 0);
+	ASSERT(timer_fd >= 0);
+#endif
 }
 
 static void dispose(void)
 {
-	if (g_asset_splash)
-	{
-		free(g_asset_splash);
-	}
+	frame_stats_write_json(frame_stats_file, c_screen_names);
 
-	if (g_asset_game_over)
-	{
-		free(g_asset_game_over);
-	}
+	destroy_screens();
+	assets_close();
+	arena_dispose(&g_screens_arena);
+	score_store_dispose();
+	broadcast_dispose();
+
+#ifdef __linux__
+	close(timer_fd);
+#endif
 
 	use_default_colors();
 	endwin();
+
+	// also shown on the game over screen, but the game may be gone by then
+	if (score_store_get_status() == SCORE_STORE_STATUS_FAILED)
+	{
+		fprintf(stderr, "a game wasn't saved, %s\n", score_store_get_error());
+	}
 }
 
 static void loop(void)
@@ -182,46 +507,68 @@ static void loop(void)
 
 	while (g_running)
 	{
-		g_key = getch();
+		float32_t timeout	 = get_wait_time();
+		float32_t wait_start = get_current_time();
+
+		PROFILE_BEGIN(PROFILE_PHASE_WAIT);
+		wait_events(timeout);
+		PROFILE_END(PROFILE_PHASE_WAIT);
 
-		if (g_key == KEY_F(1) || g_key == CH_ESC)
+		PROFILE_BEGIN(PROFILE_PHASE_INPUT);
+		uint64_t  allocations = memory_get_allocations();
+		float32_t now		  = get_current_time();
+		input_update(now);
+		PROFILE_END(PROFILE_PHASE_INPUT);
+
+		if (input_key_pressed(KEY_F(1)) || input_key_pressed(CH_ESC))
 		{
 			break;
 		}
-		else if (g_key == KEY_RESIZE)
+		else if (input_key_pressed(KEY_RESIZE))
 		{
 			resize_term(TERMINAL_ROWS, TERMINAL_COLS);
 			noecho();
 			cbreak();
 			curs_set(0);
-			refresh();
+			wnoutrefresh(stdscr);
 
-			if (screen_action_window_resized)
+			if (screen)
 			{
-				screen_action_window_resized();
+				screen->window_resized();
 			}
 		}
 
-		float32_t now			  = get_current_time();
 		float32_t real_delta_time = now - last_update_time;
 		last_update_time		  = now;
 
-		if (real_delta_time < c_target_frame_time)
-		{
-			uint32_t ms = (uint32_t)((c_target_frame_time - real_delta_time) * 1000);
-			napms(ms);
-		}
-
-		g_delta_time = real_delta_time;
+		g_delta_time = real_delta_time < c_max_delta_time ? real_delta_time : c_max_delta_time;
 
+		PROFILE_BEGIN(PROFILE_PHASE_UPDATE);
 		update_state();
-		screen_action_update();
-		screen_action_render();
+		screen->update();
+		PROFILE_END(PROFILE_PHASE_UPDATE);
+
+		PROFILE_BEGIN(PROFILE_PHASE_RENDER);
+		screen->render();
+		PROFILE_END(PROFILE_PHASE_RENDER);
+
+		// every window drawn this frame goes out in a single terminal write
+		PROFILE_BEGIN(PROFILE_PHASE_REFRESH);
+		compositor_flush();
+		PROFILE_END(PROFILE_PHASE_REFRESH);
+		PROFILE_FRAME_END();
+
+		// early (negative) when woken up by input
+		float32_t lateness = timeout >= 0 ? now - (wait_start + timeout) : 0;
+		allocations		   = memory_get_allocations() - allocations;
+		frame_stats_add(current_screen, real_delta_time, get_current_time() - now, lateness, allocations);
+		PROFILE_COUNT(PROFILE_COUNTER_ALLOCATIONS, allocations);
 	}
 
-	if (screen_action_dispose)
+	if (screen)
 	{
-		screen_action_dispose();
+		screen->dispose();
+		compositor_flush();
 	}
 }
 
@@ -229,81 +576,158 @@ static void update_state(void)
 {
 	if (!current_screen)
 	{
-		screen_action_init			 = &screen_init_init;
-		screen_action_dispose		 = &screen_init_dispose;
-		screen_action_update		 = &screen_init_update;
-		screen_action_render		 = &screen_init_render;
-		screen_is_completed			 = &screen_init_is_completed;
-		screen_action_window_resized = NULL;
-		screen_action_init();
-		current_screen = SCREEN_INIT;
+		enter_screen(g_watch_path ? SCREEN_WATCH : versus ? SCREEN_VERSUS : SCREEN_INIT);
+	}
+	else if (current_screen == SCREEN_VERSUS && screen->is_completed())
+	{
+		enter_screen(SCREEN_VERSUS);
 	}
 	else if ((current_screen == SCREEN_INIT ||
 			  current_screen == SCREEN_GAME_OVER) &&
-			 screen_is_completed())
+			 screen->is_completed())
 	{
-		screen_action_dispose();
-		screen_action_init			 = &screen_stage_init;
-		screen_action_dispose		 = &screen_stage_dispose;
-		screen_action_update		 = &screen_stage_update;
-		screen_action_render		 = &screen_stage_render;
-		screen_is_completed			 = &screen_stage_is_completed;
-		screen_action_window_resized = &screen_stage_window_resized;
-		screen_action_init();
-		current_screen = SCREEN_STAGE;
+		enter_screen(SCREEN_STAGE);
 	}
-	else if (current_screen == SCREEN_STAGE && screen_is_completed())
+	else if (current_screen == SCREEN_STAGE && screen->is_completed())
 	{
-		screen_action_dispose();
-		screen_action_init			 = &screen_game_over_init;
-		screen_action_dispose		 = &screen_game_over_dispose;
-		screen_action_update		 = &screen_game_over_update;
-		screen_action_render		 = &screen_game_over_render;
-		screen_is_completed			 = &screen_game_over_is_completed;
-		screen_action_window_resized = &screen_game_over_window_resized;
-		screen_action_init();
-		current_screen = SCREEN_GAME_OVER;
+		enter_screen(SCREEN_GAME_OVER);
 	}
 }
 
-static void load_assets(void)
+// the previous screen's windows are erased in the same frame the next one
+// is drawn, and only created the first time
+static void enter_screen(screen_t next)
+{
+	if (screen)
+	{
+		screen->dispose();
+	}
+
+	current_screen = next;
+	screen		   = &c_screens[next];
+
+	if (!screens_created[next])
+	{
+		screen->create();
+		screens_created[next] = true;
+	}
+
+	screen->init();
+}
+
+static void destroy_screens(void)
 {
-	load_asset(FILE_SPLASH, &g_asset_splash);
-	load_asset(FILE_GAME_OVER, &g_asset_game_over);
+	for (uint8_t i = 0; i < SCREEN_COUNT; i++)
+	{
+		if (screens_created[i])
+		{
+			c_screens[i].destroy();
+			screens_created[i] = false;
+		}
+	}
 }
 
-static void load_asset(const char *file, char **dest)
+// every asset is in the packed file, mapped for the whole session
+static void load_assets(void)
 {
-	FILE *f = fopen(file, "r");
-	ASSERT(f);
+	ASSERT(assets_open(FILE_ASSETS));
+	load_asset("splash", &g_asset_splash);
+	load_asset("game_over", &g_asset_game_over);
+}
 
-	fseek(f, 0, SEEK_END);
-	int32_t length = ftell(f) + 1;
-	fseek(f, 0, SEEK_SET);
-	*dest = calloc(length, sizeof(char));
+static void load_asset(const char *name, const asset_t **dest)
+{
+	*dest = assets_get(name);
 	ASSERT(*dest);
-
-	fread(*dest, sizeof(char), length, f);
-	fclose(f);
 }
 
+// the record is the user's best game, games are saved in the background (see
+// score_store.h)
 static void load_score(void)
 {
-	FILE *f = fopen(FILE_SCORE, "r");
+	ASSERT(score_store_init(FILE_SCORE, get_user()));
+	score_store_load(&g_score.record);
+}
+
+// seconds until the current screen needs a frame or a held key repeats, but
+// no less than what's left of the current one. negative when only input can
+// change the screen
+static float32_t get_wait_time(void)
+{
+	float32_t now			  = get_current_time();
+	float32_t frame_time_left = c_target_frame_time - (now - last_update_time);
+	float32_t wakeup		  = screen ? screen->next_wakeup() : 0;
+	float32_t repeat		  = input_get_next_repeat_time(now);
 
-	if (!f)
+	if (repeat >= 0 && (wakeup < 0 || repeat < wakeup))
+	{
+		wakeup = repeat;
+	}
+
+	if (wakeup < 0)
+	{
+		return SCREEN_WAKEUP_IDLE;
+	}
+
+	return wakeup > frame_time_left ? wakeup : frame_time_left;
+}
+
+// sleeps until a key is pressed, the screen's descriptor (if any) is
+// readable or the timeout (seconds) expires
+static void wait_events(float32_t timeout)
+{
+	if (timeout >= 0 && timeout < 1e-4)
 	{
 		return;
 	}
 
-	fscanf(f, "%hu;", &g_score.record);
-	fclose(f);
+#ifdef __linux__
+	int				  screen_fd = screen && screen->wait_fd ? screen->wait_fd() : -1;
+	struct pollfd	  fds[3]	= { { .fd = STDIN_FILENO, .events = POLLIN }, { .fd = timer_fd, .events = POLLIN }, { .fd = screen_fd, .events = POLLIN } };
+	struct itimerspec timer		= { 0 };
+	uint64_t		  expirations;
+
+	// disarmed timer when idle
+	if (timeout > 0)
+	{
+		timer.it_value.tv_sec  = (time_t)timeout;
+		timer.it_value.tv_nsec = (long)((timeout - (time_t)timeout) * 1e9);
+	}
+
+	timerfd_settime(timer_fd, 0, &timer, NULL);
+
+	// interrupted by signals too (e.g. window resize), which is fine
+	// a negative fd (no screen's) is left out
+	if (poll(fds, 3, -1) > 0 && (fds[1].revents & POLLIN))
+	{
+		read(timer_fd, &expirations, sizeof(expirations));
+	}
+#else
+	// input can't be waited on, so sleep no longer than a frame
+	if (timeout < 0 || timeout > c_target_frame_time)
+	{
+		timeout = c_target_frame_time;
+	}
+
+	napms((int)(timeout * 1000));
+#endif
 }
 
+// seconds since the first call. From the monotonic clock origin (boot) a
+// float32 would be off by milliseconds after a few hours of uptime
 static float32_t get_current_time(void)
 {
-	struct timespec now;
+	static float64_t start = -1;
+	struct timespec	 now;
+
 	clock_gettime(CLOCK_MONOTONIC, &now);
 
-	return now.tv_sec + (now.tv_nsec / 1e9);
+	float64_t seconds = now.tv_sec + (now.tv_nsec / 1e9);
+
+	if (start < 0)
+	{
+		start = seconds;
+	}
+
+	return seconds - start;
 }
@@ -0,0 +1,163 @@
+#include "../assets.h"
+#include "../common.h"
+
+// builds the packed assets file (see assets.h) from text files, one asset
+// per file named after it: pack <output> <file>...
+typedef struct source_t
+{
+	char	 name[ASSETS_NAME_SIZE];
+	char	*text;
+	uint32_t length;
+	uint32_t lines_count;
+	uint32_t lines_length; // without line breaks
+	uint32_t width;
+} source_t;
+
+static source_t sources[ASSETS_MAX];
+
+static void		load_source(source_t *source, const char *file);
+static void		index_lines(source_t *source);
+static uint32_t next_line(const source_t *source, uint32_t start, uint32_t *length);
+
+int main(int argc, char *argv[])
+{
+	assets_header_t header		  = { .version = ASSETS_VERSION };
+	uint32_t		sources_count = argc - 2;
+	uint32_t		lines_offset  = sizeof(assets_header_t) + (sources_count * sizeof(assets_entry_t));
+	uint32_t		text_offset	  = lines_offset;
+
+	if (argc < 3 || sources_count > ASSETS_MAX)
+	{
+		fprintf(stderr, "usage: %s <output> <file>... (up to %d files)\n", argv[0], ASSETS_MAX);
+		return 1;
+	}
+
+	for (uint32_t i = 0; i < sources_count; i++)
+	{
+		load_source(&sources[i], argv[i + 2]);
+		text_offset += sources[i].lines_count * sizeof(asset_line_t);
+	}
+
+	FILE *f = fopen(argv[1], "wb");
+	ASSERT(f);
+
+	memcpy(header.magic, ASSETS_MAGIC, sizeof(header.magic));
+	header.assets_count = sources_count;
+	header.size			= text_offset;
+
+	for (uint32_t i = 0; i < sources_count; i++)
+	{
+		header.size += sources[i].lines_length;
+	}
+
+	fwrite(&header, sizeof(header), 1, f);
+
+	// entries
+	for (uint32_t i = 0; i < sources_count; i++)
+	{
+		const source_t *source = &sources[i];
+		assets_entry_t	entry  = { .lines_offset = lines_offset, .lines_count = source->lines_count, .width = source->width };
+
+		memcpy(entry.name, source->name, sizeof(entry.name));
+		fwrite(&entry, sizeof(entry), 1, f);
+		lines_offset += source->lines_count * sizeof(asset_line_t);
+	}
+
+	// lines tables, text is written as it is minus the line breaks
+	for (uint32_t i = 0, offset = text_offset; i < sources_count; i++)
+	{
+		const source_t *source = &sources[i];
+		uint32_t		start  = 0;
+		uint32_t		length = 0;
+
+		for (uint32_t line = 0; line < source->lines_count; line++)
+		{
+			start = next_line(source, start, &length);
+
+			asset_line_t entry = { .offset = offset, .length = length };
+			offset += length;
+
+			fwrite(&entry, sizeof(entry), 1, f);
+		}
+	}
+
+	for (uint32_t i = 0; i < sources_count; i++)
+	{
+		const source_t *source = &sources[i];
+		uint32_t		start  = 0;
+		uint32_t		length = 0;
+
+		for (uint32_t line = 0; line < source->lines_count; line++)
+		{
+			uint32_t line_start = start;
+
+			start = next_line(source, start, &length);
+			fwrite(source->text + line_start, 1, length, f);
+		}
+
+		free(source->text);
+	}
+
+	ASSERT(ftell(f) == (long)header.size);
+	ASSERT(fclose(f) == 0);
+
+	return 0;
+}
+
+static void load_source(source_t *source, const char *file)
+{
+	const char *base		= strrchr(file, '/') ? strrchr(file, '/') + 1 : file;
+	const char *ext			= strrchr(base, '.');
+	size_t		name_length = ext ? (size_t)(ext - base) : strlen(base);
+	FILE	   *f			= fopen(file, "rb");
+
+	ASSERT(f);
+	ASSERT(name_length < ASSETS_NAME_SIZE);
+
+	memset(source, 0, sizeof(source_t));
+	memcpy(source->name, base, name_length);
+
+	fseek(f, 0, SEEK_END);
+	source->length = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	source->text = malloc(source->length + 1);
+	ASSERT(source->text);
+	ASSERT(fread(source->text, 1, source->length, f) == source->length);
+	fclose(f);
+
+	index_lines(source);
+}
+
+// a last line without line break counts too
+static void index_lines(source_t *source)
+{
+	uint32_t length;
+
+	for (uint32_t start = 0; start < source->length; source->lines_count++)
+	{
+		start = next_line(source, start, &length);
+		source->lines_length += length;
+		source->width = length > source->width ? length : source->width;
+	}
+}
+
+// length of the line at start (line break excluded, \r too) and the start of
+// the next one
+static uint32_t next_line(const source_t *source, uint32_t start, uint32_t *length)
+{
+	uint32_t end = start;
+
+	while (end < source->length && source->text[end] != '\n')
+	{
+		end++;
+	}
+
+	*length = end - start;
+
+	if (*length > 0 && source->text[end - 1] == '\r')
+	{
+		(*length)--;
+	}
+
+	return end < source->length ? end + 1 : end;
+}
\ No newline at end of file
@@ -0,0 +1,167 @@
+#define _POSIX_C_SOURCE 199309L
+#include "profile.h"
+
+#ifdef PROFILE
+
+#include <time.h>
+
+#define PROFILE_MAX_DEPTH 4
+
+// an open phase. A phase begun inside another one pauses it, so nested
+// phases aren't counted twice
+typedef struct open_phase_t
+{
+	profile_phase_t phase;
+	float64_t		start;
+} open_phase_t;
+
+static const char *c_phase_names[PROFILE_PHASE_COUNT]	  = { "wait", "input", "update", "render", "refresh" };
+static const char *c_counter_names[PROFILE_COUNTER_COUNT] = { "cells", "collisions", "allocations" };
+
+static open_phase_t open_phases[PROFILE_MAX_DEPTH];
+static uint8_t		open_phases_count;
+static float64_t	phase_times[PROFILE_PHASE_COUNT]; // current frame
+static uint32_t		counters[PROFILE_COUNTER_COUNT];  // current frame
+static float32_t	phase_frames[PROFILE_PHASE_COUNT][PROFILE_FRAMES];
+static float32_t	busy_frames[PROFILE_FRAMES];
+static float32_t	counter_frames[PROFILE_COUNTER_COUNT][PROFILE_FRAMES];
+static uint32_t		frames_count;
+
+static float64_t get_time(void);
+static void		 get_stats(const float32_t *frames, profile_stats_t *stats);
+static int		 compare_float32(const void *a, const void *b);
+
+void profile_begin(profile_phase_t phase)
+{
+	float64_t now = get_time();
+
+	if (open_phases_count == PROFILE_MAX_DEPTH)
+	{
+		return;
+	}
+
+	if (open_phases_count > 0)
+	{
+		open_phase_t *outer = &open_phases[open_phases_count - 1];
+		phase_times[outer->phase] += now - outer->start;
+	}
+
+	open_phases[open_phases_count++] = (open_phase_t){ .phase = phase, .start = now };
+}
+
+void profile_end(profile_phase_t phase)
+{
+	float64_t now = get_time();
+
+	if (open_phases_count == 0 || open_phases[open_phases_count - 1].phase != phase)
+	{
+		return;
+	}
+
+	open_phases_count--;
+	phase_times[phase] += now - open_phases[open_phases_count].start;
+
+	if (open_phases_count > 0)
+	{
+		open_phases[open_phases_count - 1].start = now;
+	}
+}
+
+void profile_count(profile_counter_t counter, uint32_t value)
+{
+	counters[counter] += value;
+}
+
+// moves the current frame times and counters to the window
+void profile_frame_end(void)
+{
+	uint32_t  index = frames_count++ % PROFILE_FRAMES;
+	float64_t busy	= 0;
+
+	for (uint8_t i = 0; i < PROFILE_PHASE_COUNT; i++)
+	{
+		phase_frames[i][index] = phase_times[i] * 1e3;
+		busy += i != PROFILE_PHASE_WAIT ? phase_times[i] : 0;
+		phase_times[i] = 0;
+	}
+
+	for (uint8_t i = 0; i < PROFILE_COUNTER_COUNT; i++)
+	{
+		counter_frames[i][index] = counters[i];
+		counters[i]				 = 0;
+	}
+
+	busy_frames[index] = busy * 1e3;
+}
+
+// in milliseconds
+void profile_get_phase_stats(profile_phase_t phase, profile_stats_t *stats)
+{
+	get_stats(phase_frames[phase], stats);
+}
+
+// every phase but wait, in milliseconds
+void profile_get_busy_stats(profile_stats_t *stats)
+{
+	get_stats(busy_frames, stats);
+}
+
+void profile_get_counter_stats(profile_counter_t counter, profile_stats_t *stats)
+{
+	get_stats(counter_frames[counter], stats);
+}
+
+const char *profile_get_phase_name(profile_phase_t phase)
+{
+	return c_phase_names[phase];
+}
+
+const char *profile_get_counter_name(profile_counter_t counter)
+{
+	return c_counter_names[counter];
+}
+
+static float64_t get_time(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return now.tv_sec + (now.tv_nsec / 1e9);
+}
+
+static void get_stats(const float32_t *frames, profile_stats_t *stats)
+{
+	float32_t sorted[PROFILE_FRAMES];
+	uint32_t  count = frames_count < PROFILE_FRAMES ? frames_count : PROFILE_FRAMES;
+	float64_t sum	= 0;
+
+	memset(stats, 0, sizeof(profile_stats_t));
+
+	if (count == 0)
+	{
+		return;
+	}
+
+	memcpy(sorted, frames, count * sizeof(float32_t));
+	qsort(sorted, count, sizeof(float32_t), compare_float32);
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		sum += sorted[i];
+	}
+
+	stats->min	= sorted[0];
+	stats->mean = sum / count;
+	stats->p99	= sorted[(uint32_t)ceil(count * 0.99) - 1];
+	stats->max	= sorted[count - 1];
+}
+
+static int compare_float32(const void *a, const void *b)
+{
+	float32_t x = *(const float32_t *)a;
+	float32_t y = *(const float32_t *)b;
+
+	return (x > y) - (x < y);
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,63 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include "types.h"
+
+// frame timing of each phase and per frame counters, over the last
+// PROFILE_FRAMES frames. Everything is compiled out unless built with
+// PROFILE defined (make PROFILE=1)
+#define PROFILE_FRAMES 128
+
+typedef enum profile_phase_t
+{
+	PROFILE_PHASE_WAIT	  = 0, // waiting for input or the next frame
+	PROFILE_PHASE_INPUT	  = 1,
+	PROFILE_PHASE_UPDATE  = 2,
+	PROFILE_PHASE_RENDER  = 3, // refresh excluded
+	PROFILE_PHASE_REFRESH = 4, // doupdate, curses output to the terminal
+	PROFILE_PHASE_COUNT	  = 5
+} profile_phase_t;
+
+typedef enum profile_counter_t
+{
+	PROFILE_COUNTER_CELLS		= 0, // board and next shape cells drawn
+	PROFILE_COUNTER_COLLISIONS	= 1, // engine shape and board overlap checks
+	PROFILE_COUNTER_ALLOCATIONS = 2, // heap, see memory.h
+	PROFILE_COUNTER_COUNT		= 3
+} profile_counter_t;
+
+typedef struct profile_stats_t
+{
+	float32_t min;
+	float32_t mean;
+	float32_t p99;
+	float32_t max;
+} profile_stats_t;
+
+#ifdef PROFILE
+
+#define PROFILE_BEGIN(phase) profile_begin(phase)
+#define PROFILE_END(phase) profile_end(phase)
+#define PROFILE_COUNT(counter, value) profile_count(counter, value)
+#define PROFILE_FRAME_END() profile_frame_end()
+
+void		profile_begin(profile_phase_t phase);
+void		profile_end(profile_phase_t phase);
+void		profile_count(profile_counter_t counter, uint32_t value);
+void		profile_frame_end(void);
+void		profile_get_phase_stats(profile_phase_t phase, profile_stats_t *stats);
+void		profile_get_busy_stats(profile_stats_t *stats);
+void		profile_get_counter_stats(profile_counter_t counter, profile_stats_t *stats);
+const char *profile_get_phase_name(profile_phase_t phase);
+const char *profile_get_counter_name(profile_counter_t counter);
+
+#else
+
+#define PROFILE_BEGIN(phase) ((void)0)
+#define PROFILE_END(phase) ((void)0)
+#define PROFILE_COUNT(counter, value) ((void)(value))
+#define PROFILE_FRAME_END() ((void)0)
+
+#endif
+
+#endif
\ No newline at end of file
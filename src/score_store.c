@@ -0,0 +1,238 @@
+#define _POSIX_C_SOURCE 200809L
+#include "score_store.h"
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+
+#define SCORE_STORE_PATH_SIZE 256
+#define SCORE_STORE_ERROR_SIZE (SCORE_STORE_PATH_SIZE + 128)
+
+// shared with the writer thread, under lock
+static struct
+{
+	pthread_t			 thread;
+	pthread_mutex_t		 lock;
+	pthread_cond_t		 cond;
+	leaderboard_entry_t	 queue[SCORE_STORE_QUEUE_CAPACITY]; // to be written, oldest first
+	uint8_t				 queue_start;
+	uint8_t				 queue_count;
+	bool				 failed; // some save of the pending ones
+	bool				 quit;
+	score_store_status_t status;
+	char				 error[SCORE_STORE_ERROR_SIZE];
+} store;
+
+static char file_path[SCORE_STORE_PATH_SIZE];
+static char user_name[LEADERBOARD_USER_SIZE];
+static char error_copy[SCORE_STORE_ERROR_SIZE]; // store.error as last read by the thread that saves
+static bool running = false;
+
+static void *run_writer(void *arg);
+static bool	 write_entry(const leaderboard_entry_t *entry, char *error);
+
+bool score_store_init(const char *file, const char *user)
+{
+	if (snprintf(file_path, sizeof(file_path), "%s", file) >= (int)sizeof(file_path))
+	{
+		return false;
+	}
+
+	// longer names are cut, as they are on the leaderboard
+	snprintf(user_name, sizeof(user_name), "%s", user);
+	memset(&store, 0, sizeof(store));
+
+	if (pthread_mutex_init(&store.lock, NULL) != 0 || pthread_cond_init(&store.cond, NULL) != 0)
+	{
+		return false;
+	}
+
+	running = pthread_create(&store.thread, NULL, run_writer, NULL) == 0;
+
+	return running;
+}
+
+// waits for the pending saves, if any, to be written
+void score_store_dispose(void)
+{
+	if (!running)
+	{
+		return;
+	}
+
+	pthread_mutex_lock(&store.lock);
+	store.quit = true;
+	pthread_cond_signal(&store.cond);
+	pthread_mutex_unlock(&store.lock);
+
+	pthread_join(store.thread, NULL);
+	pthread_cond_destroy(&store.cond);
+	pthread_mutex_destroy(&store.lock);
+	running = false;
+}
+
+// the user's best score, at startup. False when there's none yet
+bool score_store_load(uint16_t *record)
+{
+	leaderboard_t		board;
+	leaderboard_entry_t best;
+	bool				loaded;
+
+	if (!leaderboard_open(&board, file_path))
+	{
+		return false;
+	}
+
+	loaded = leaderboard_get_user_top(&board, user_name, &best, 1) == 1;
+	leaderboard_close(&board);
+
+	if (loaded)
+	{
+		*record = best.score > UINT16_MAX ? UINT16_MAX : best.score;
+	}
+
+	return loaded;
+}
+
+// the user and time of the entry are filled here
+void score_store_save(const leaderboard_entry_t *entry)
+{
+	if (!running)
+	{
+		return;
+	}
+
+	pthread_mutex_lock(&store.lock);
+
+	if (store.queue_count == SCORE_STORE_QUEUE_CAPACITY)
+	{
+		store.failed = true;
+		store.status = SCORE_STORE_STATUS_FAILED;
+		snprintf(store.error, sizeof(store.error), "too many games waiting to be saved");
+		pthread_mutex_unlock(&store.lock);
+		return;
+	}
+
+	leaderboard_entry_t *queued = &store.queue[(store.queue_start + store.queue_count++) % SCORE_STORE_QUEUE_CAPACITY];
+
+	*queued		  = *entry;
+	queued->time  = time(NULL);
+	store.status  = store.failed ? SCORE_STORE_STATUS_FAILED : SCORE_STORE_STATUS_PENDING;
+	memcpy(queued->user, user_name, sizeof(queued->user));
+	pthread_cond_signal(&store.cond);
+	pthread_mutex_unlock(&store.lock);
+}
+
+score_store_status_t score_store_get_status(void)
+{
+	// the writer is done (or never started), nothing to race with
+	if (!running)
+	{
+		return store.status;
+	}
+
+	pthread_mutex_lock(&store.lock);
+	score_store_status_t status = store.status;
+	pthread_mutex_unlock(&store.lock);
+
+	return status;
+}
+
+// what the last failed save couldn't do. Only valid while the status is
+// SCORE_STORE_STATUS_FAILED, from the thread that saves. The writer may set
+// it again meanwhile, what's returned is a copy taken under the lock
+const char *score_store_get_error(void)
+{
+	// the writer is done (or never started), nothing to race with
+	if (!running)
+	{
+		return store.error;
+	}
+
+	pthread_mutex_lock(&store.lock);
+	memcpy(error_copy, store.error, sizeof(error_copy));
+	pthread_mutex_unlock(&store.lock);
+
+	return error_copy;
+}
+
+static void *run_writer(void *arg)
+{
+	char				error[SCORE_STORE_ERROR_SIZE];
+	leaderboard_entry_t entry;
+
+	(void)arg;
+	pthread_mutex_lock(&store.lock);
+
+	while (true)
+	{
+		while (!store.queue_count && !store.quit)
+		{
+			pthread_cond_wait(&store.cond, &store.lock);
+		}
+
+		if (!store.queue_count)
+		{
+			break;
+		}
+
+		entry = store.queue[store.queue_start];
+
+		// the file is written without the lock, saves meanwhile are queued.
+		// The entry stays queued until then, so its slot isn't reused
+		pthread_mutex_unlock(&store.lock);
+		bool saved = write_entry(&entry, error);
+		pthread_mutex_lock(&store.lock);
+
+		store.queue_start = (store.queue_start + 1) % SCORE_STORE_QUEUE_CAPACITY;
+		store.queue_count--;
+
+		if (!saved)
+		{
+			store.failed = true;
+			memcpy(store.error, error, sizeof(store.error));
+		}
+
+		// a failure is reported until every pending save is written
+		if (!store.queue_count)
+		{
+			store.status = store.failed ? SCORE_STORE_STATUS_FAILED : SCORE_STORE_STATUS_SAVED;
+			store.failed = false;
+		}
+		else if (store.failed)
+		{
+			store.status = SCORE_STORE_STATUS_FAILED;
+		}
+	}
+
+	pthread_mutex_unlock(&store.lock);
+
+	return NULL;
+}
+
+// appended (and synced) under the log's lock, other games may be saving to
+// it too. A compaction that fails leaves the log as it was, it's tried again
+// by the next save
+static bool write_entry(const leaderboard_entry_t *entry, char *error)
+{
+	leaderboard_t board;
+
+	if (!leaderboard_append(file_path, entry))
+	{
+		snprintf(error, SCORE_STORE_ERROR_SIZE, "can't append to %s: %s", file_path, strerror(errno));
+		return false;
+	}
+
+	if (leaderboard_open(&board, file_path))
+	{
+		bool needs_compaction = leaderboard_needs_compaction(&board);
+
+		leaderboard_close(&board);
+
+		if (needs_compaction)
+		{
+			leaderboard_compact(file_path);
+		}
+	}
+
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,26 @@
+#ifndef SCORE_STORE_H
+#define SCORE_STORE_H
+
+#include "leaderboard.h"
+
+// games persistence, on the leaderboard (see leaderboard.h). Saving never
+// blocks: the game is queued for a writer thread that appends it to the log
+// and compacts it when due. Saves fail when the queue is full
+#define SCORE_STORE_QUEUE_CAPACITY 8
+
+typedef enum score_store_status_t
+{
+	SCORE_STORE_STATUS_IDLE	   = 0, // nothing saved yet
+	SCORE_STORE_STATUS_PENDING = 1,
+	SCORE_STORE_STATUS_SAVED   = 2,
+	SCORE_STORE_STATUS_FAILED  = 3 // see score_store_get_error
+} score_store_status_t;
+
+bool				 score_store_init(const char *file, const char *user);
+void				 score_store_dispose(void);
+bool				 score_store_load(uint16_t *record);
+void				 score_store_save(const leaderboard_entry_t *entry);
+score_store_status_t score_store_get_status(void);
+const char			*score_store_get_error(void);
+
+#endif
\ No newline at end of file
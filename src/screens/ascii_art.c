@@ -0,0 +1,54 @@
+#include "ascii_art.h"
+
+ascii_art_t ascii_art_new(arena_t *arena, const asset_t *asset, chtype attrs)
+{
+	ascii_art_t art;
+	const char *line;
+	uint32_t	length;
+
+	art.arena = arena;
+	art.rows  = asset->lines_count;
+	art.cols  = asset->width;
+	art.cells = (chtype *)(arena ? arena_alloc(arena, art.rows * art.cols * sizeof(chtype)) : memory_alloc(art.rows * art.cols * sizeof(chtype)));
+
+	ASSERT(art.cells || art.rows * art.cols == 0);
+
+	for (uint16_t y = 0; (line = asset_get_line(asset, y, &length)); y++)
+	{
+		chtype *row = &art.cells[art.cols * y];
+
+		for (uint16_t x = 0; x < art.cols; x++)
+		{
+			row[x] = (x < length ? (unsigned char)line[x] : ' ') | attrs;
+		}
+	}
+
+	return art;
+}
+
+void ascii_art_dispose(ascii_art_t *art)
+{
+	if (!art->arena)
+	{
+		memory_free(art->cells);
+	}
+
+	art->cells = NULL;
+}
+
+// replaces the attributes of the rows from first_row to the last one
+void ascii_art_set_attrs(ascii_art_t *art, uint16_t first_row, chtype attrs)
+{
+	for (uint32_t i = first_row * art->cols; i < (uint32_t)(art->rows * art->cols); i++)
+	{
+		art->cells[i] = (art->cells[i] & A_CHARTEXT) | attrs;
+	}
+}
+
+void ascii_art_draw(const ascii_art_t *art, render_window_t *win)
+{
+	for (uint16_t y = 0; y < art->rows; y++)
+	{
+		render_cells(win, y, 0, &art->cells[art->cols * y], art->cols);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,25 @@
+#ifndef ASCII_ART_H
+#define ASCII_ART_H
+
+#include "../assets.h"
+#include "../common.h"
+#include "../data_structures/arena.h"
+#include "../defs.h"
+#include "render.h"
+
+// an asset converted once to cells (char and attributes), rows padded with
+// spaces to the widest one, so drawing is a render_cells per row
+typedef struct ascii_art_t
+{
+	arena_t *arena; // NULL for the heap
+	chtype	*cells;
+	uint16_t rows;
+	uint16_t cols;
+} ascii_art_t;
+
+ascii_art_t ascii_art_new(arena_t *arena, const asset_t *asset, chtype attrs);
+void		ascii_art_dispose(ascii_art_t *art);
+void		ascii_art_set_attrs(ascii_art_t *art, uint16_t first_row, chtype attrs);
+void		ascii_art_draw(const ascii_art_t *art, render_window_t *win);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,84 @@
+#include "cell_buffer.h"
+
+// never produced by curses, forces the cell to be sent on next flush
+#define CELL_INVALID ((chtype)~0)
+
+cell_buffer_t cell_buffer_new(arena_t *arena, render_window_t *win, uint16_t rows, uint16_t cols, uint8_t offset_y, uint8_t offset_x)
+{
+	cell_buffer_t buffer;
+
+	buffer.win		  = win;
+	buffer.arena	  = arena;
+	buffer.rows		  = rows;
+	buffer.cols		  = cols;
+	buffer.offset_y	  = offset_y;
+	buffer.offset_x	  = offset_x;
+	buffer.cells	  = (chtype *)(arena ? arena_alloc(arena, rows * cols * sizeof(chtype)) : memory_alloc(rows * cols * sizeof(chtype)));
+	buffer.prev_cells = (chtype *)(arena ? arena_alloc(arena, rows * cols * sizeof(chtype)) : memory_alloc(rows * cols * sizeof(chtype)));
+
+	ASSERT(buffer.cells && buffer.prev_cells);
+
+	cell_buffer_clear(&buffer);
+	cell_buffer_invalidate(&buffer);
+
+	return buffer;
+}
+
+void cell_buffer_dispose(cell_buffer_t *buffer)
+{
+	if (!buffer->arena)
+	{
+		memory_free(buffer->cells);
+		memory_free(buffer->prev_cells);
+	}
+
+	buffer->cells	   = NULL;
+	buffer->prev_cells = NULL;
+}
+
+void cell_buffer_clear(cell_buffer_t *buffer)
+{
+	for (uint32_t i = 0; i < (uint32_t)(buffer->rows * buffer->cols); i++)
+	{
+		buffer->cells[i] = ' ';
+	}
+}
+
+void cell_buffer_invalidate(cell_buffer_t *buffer)
+{
+	for (uint32_t i = 0; i < (uint32_t)(buffer->rows * buffer->cols); i++)
+	{
+		buffer->prev_cells[i] = CELL_INVALID;
+	}
+}
+
+// consecutive changed cells of a row are drawn at once
+uint32_t cell_buffer_flush(cell_buffer_t *buffer)
+{
+	uint32_t cells_drawn = 0;
+
+	for (uint16_t y = 0; y < buffer->rows; y++)
+	{
+		chtype *row		 = &buffer->cells[buffer->cols * y];
+		chtype *prev_row = &buffer->prev_cells[buffer->cols * y];
+
+		for (uint16_t x = 0; x < buffer->cols; x++)
+		{
+			uint16_t start = x;
+
+			while (x < buffer->cols && row[x] != prev_row[x])
+			{
+				prev_row[x] = row[x];
+				x++;
+			}
+
+			if (x > start)
+			{
+				render_cells(buffer->win, y + buffer->offset_y, start + buffer->offset_x, &row[start], x - start);
+				cells_drawn += x - start;
+			}
+		}
+	}
+
+	return cells_drawn;
+}
\ No newline at end of file
@@ -0,0 +1,32 @@
+#ifndef CELL_BUFFER_H
+#define CELL_BUFFER_H
+
+#include "../common.h"
+#include "../data_structures/arena.h"
+#include "../defs.h"
+#include "render.h"
+
+// cells of a window region. Frames are composed on `cells` and flush only
+// sends the ones that differ from `prev_cells` (what's already on screen)
+typedef struct cell_buffer_t
+{
+	render_window_t *win;
+	arena_t			*arena; // NULL for the heap
+	chtype			*cells;
+	chtype			*prev_cells;
+	uint16_t		 rows;
+	uint16_t		 cols;
+	uint8_t			 offset_y;
+	uint8_t			 offset_x;
+} cell_buffer_t;
+
+#define CELL_BUFFER_SET(buffer, y, x, ch)                                                                                                              \
+	(((int32_t)(y) >= 0 && (int32_t)(y) < (buffer).rows && (int32_t)(x) >= 0 && (int32_t)(x) < (buffer).cols) ? (buffer).cells[(buffer).cols * (y) + (x)] = (ch), 1 : 0)
+
+cell_buffer_t cell_buffer_new(arena_t *arena, render_window_t *win, uint16_t rows, uint16_t cols, uint8_t offset_y, uint8_t offset_x);
+void		  cell_buffer_dispose(cell_buffer_t *buffer);
+void		  cell_buffer_clear(cell_buffer_t *buffer);
+void		  cell_buffer_invalidate(cell_buffer_t *buffer);
+uint32_t	  cell_buffer_flush(cell_buffer_t *buffer);
+
+#endif
\ No newline at end of file
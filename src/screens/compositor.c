@@ -0,0 +1,23 @@
+#include "compositor.h"
+
+static uint32_t submitted = 0; // windows since the last flush
+
+void compositor_submit(render_window_t *win)
+{
+	render_submit(win);
+	submitted++;
+}
+
+// false when nothing was submitted, there's nothing to send
+bool compositor_flush(void)
+{
+	if (!submitted)
+	{
+		return false;
+	}
+
+	render_flush();
+	submitted = 0;
+
+	return true;
+}
\ No newline at end of file
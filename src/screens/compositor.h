@@ -0,0 +1,12 @@
+#ifndef COMPOSITOR_H
+#define COMPOSITOR_H
+
+#include "render.h"
+
+// screens submit the windows they draw (with curses, wnoutrefresh: only the
+// virtual screen is updated) and the main loop sends all of them to the
+// terminal at once, with a single flush (doupdate) at the end of the frame
+void compositor_submit(render_window_t *win);
+bool compositor_flush(void);
+
+#endif
\ No newline at end of file
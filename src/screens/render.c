@@ -0,0 +1,126 @@
+#include "render.h"
+#include <stdarg.h>
+
+#define RENDER_BOX_COLS_MAX 256
+
+static const render_backend_t *backend = NULL;
+
+void render_init(const render_backend_t *render_backend)
+{
+	backend = render_backend;
+}
+
+const render_backend_t *render_get_backend(void)
+{
+	return backend;
+}
+
+render_window_t render_window_new(uint16_t rows, uint16_t cols, uint16_t y, uint16_t x)
+{
+	render_window_t win = { .rows = rows, .cols = cols, .y = y, .x = x };
+
+	win.handle = backend->create_window(rows, cols, y, x);
+	ASSERT(win.handle);
+
+	return win;
+}
+
+void render_window_dispose(render_window_t *win)
+{
+	backend->destroy_window(win->handle);
+	win->handle = NULL;
+}
+
+void render_erase(render_window_t *win)
+{
+	backend->erase_window(win->handle);
+}
+
+// cells out of the window are dropped
+void render_cells(render_window_t *win, uint16_t y, uint16_t x, const chtype *cells, uint16_t count)
+{
+	if (y >= win->rows || x >= win->cols || count == 0)
+	{
+		return;
+	}
+
+	backend->draw_cells(win->handle, y, x, cells, x + count > win->cols ? win->cols - x : count);
+}
+
+// printf like, on a single row (line breaks aren't supported)
+void render_text(render_window_t *win, uint16_t y, uint16_t x, chtype attrs, const char *format, ...)
+{
+	char	text[RENDER_TEXT_SIZE];
+	chtype	cells[RENDER_TEXT_SIZE];
+	va_list args;
+	int		length;
+
+	va_start(args, format);
+	length = vsnprintf(text, sizeof(text), format, args);
+	va_end(args);
+
+	if (length <= 0)
+	{
+		return;
+	}
+
+	length = length < RENDER_TEXT_SIZE ? length : RENDER_TEXT_SIZE - 1;
+
+	for (int i = 0; i < length; i++)
+	{
+		cells[i] = (unsigned char)text[i] | attrs;
+	}
+
+	render_cells(win, y, x, cells, length);
+}
+
+// the window's border, as curses' box does it
+void render_box(render_window_t *win, chtype attrs)
+{
+	chtype row[RENDER_BOX_COLS_MAX];
+	chtype side = ACS_VLINE | attrs;
+
+	if (win->rows < 2 || win->cols < 2 || win->cols > RENDER_BOX_COLS_MAX)
+	{
+		return;
+	}
+
+	for (uint16_t x = 1; x < win->cols - 1; x++)
+	{
+		row[x] = ACS_HLINE | attrs;
+	}
+
+	row[0]			   = ACS_ULCORNER | attrs;
+	row[win->cols - 1] = ACS_URCORNER | attrs;
+	render_cells(win, 0, 0, row, win->cols);
+
+	row[0]			   = ACS_LLCORNER | attrs;
+	row[win->cols - 1] = ACS_LRCORNER | attrs;
+	render_cells(win, win->rows - 1, 0, row, win->cols);
+
+	for (uint16_t y = 1; y < win->rows - 1; y++)
+	{
+		render_cells(win, y, 0, &side, 1);
+		render_cells(win, y, win->cols - 1, &side, 1);
+	}
+}
+
+void render_touch(render_window_t *win)
+{
+	backend->touch_window(win->handle);
+}
+
+void render_submit(render_window_t *win)
+{
+	backend->submit_window(win->handle);
+}
+
+void render_flush(void)
+{
+	backend->flush_windows();
+}
+
+void render_get_size(uint16_t *rows, uint16_t *cols)
+{
+	backend->get_size(rows, cols);
+}
\ No newline at end of file
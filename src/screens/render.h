@@ -0,0 +1,48 @@
+#ifndef RENDER_H
+#define RENDER_H
+
+#include "../common.h"
+#include "../defs.h"
+
+#define RENDER_TEXT_SIZE 128 // longest text drawn at once
+
+// screens draw on render windows, never on curses directly, so the same
+// frames can go to the terminal or to memory (see render_curses.h and
+// render_framebuffer.h). Backends only deal with cells (chtype, char and
+// attributes): text and boxes are turned into cells here
+typedef struct render_window_t
+{
+	void	*handle; // the backend's window (a WINDOW with curses)
+	uint16_t rows;
+	uint16_t cols;
+	uint16_t y;
+	uint16_t x;
+} render_window_t;
+
+typedef struct render_backend_t
+{
+	const char *name;
+	void *(*create_window)(uint16_t rows, uint16_t cols, uint16_t y, uint16_t x);
+	void (*destroy_window)(void *handle);
+	void (*erase_window)(void *handle);
+	void (*draw_cells)(void *handle, uint16_t y, uint16_t x, const chtype *cells, uint16_t count);
+	void (*touch_window)(void *handle); // the whole window is sent again on next flush
+	void (*submit_window)(void *handle);
+	void (*flush_windows)(void);
+	void (*get_size)(uint16_t *rows, uint16_t *cols);
+} render_backend_t;
+
+void					render_init(const render_backend_t *backend);
+const render_backend_t *render_get_backend(void);
+render_window_t			render_window_new(uint16_t rows, uint16_t cols, uint16_t y, uint16_t x);
+void					render_window_dispose(render_window_t *win);
+void					render_erase(render_window_t *win);
+void					render_cells(render_window_t *win, uint16_t y, uint16_t x, const chtype *cells, uint16_t count);
+void					render_text(render_window_t *win, uint16_t y, uint16_t x, chtype attrs, const char *format, ...) __attribute__((format(printf, 5, 6)));
+void					render_box(render_window_t *win, chtype attrs);
+void					render_touch(render_window_t *win);
+void					render_submit(render_window_t *win);
+void					render_flush(void);
+void					render_get_size(uint16_t *rows, uint16_t *cols);
+
+#endif
\ No newline at end of file
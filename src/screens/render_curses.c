@@ -0,0 +1,79 @@
+#include "render_curses.h"
+
+static void *create_window(uint16_t rows, uint16_t cols, uint16_t y, uint16_t x);
+static void	 destroy_window(void *handle);
+static void	 erase_window(void *handle);
+static void	 draw_cells(void *handle, uint16_t y, uint16_t x, const chtype *cells, uint16_t count);
+static void	 touch_window(void *handle);
+static void	 submit_window(void *handle);
+static void	 flush_windows(void);
+static void	 get_size(uint16_t *rows, uint16_t *cols);
+
+static const render_backend_t c_backend = {
+	.name			= "curses",
+	.create_window	= &create_window,
+	.destroy_window = &destroy_window,
+	.erase_window	= &erase_window,
+	.draw_cells		= &draw_cells,
+	.touch_window	= &touch_window,
+	.submit_window	= &submit_window,
+	.flush_windows	= &flush_windows,
+	.get_size		= &get_size,
+};
+
+const render_backend_t *render_curses_get_backend(void)
+{
+	return &c_backend;
+}
+
+static void *create_window(uint16_t rows, uint16_t cols, uint16_t y, uint16_t x)
+{
+	WINDOW *win = newwin(rows, cols, y, x);
+
+	if (win)
+	{
+		scrollok(win, TRUE);
+	}
+
+	return win;
+}
+
+static void destroy_window(void *handle)
+{
+	delwin((WINDOW *)handle);
+}
+
+static void erase_window(void *handle)
+{
+	werase((WINDOW *)handle);
+}
+
+static void draw_cells(void *handle, uint16_t y, uint16_t x, const chtype *cells, uint16_t count)
+{
+	mvwaddchnstr((WINDOW *)handle, y, x, cells, count);
+}
+
+static void touch_window(void *handle)
+{
+	touchwin((WINDOW *)handle);
+}
+
+// only curses' virtual screen is updated, see compositor.h
+static void submit_window(void *handle)
+{
+	wnoutrefresh((WINDOW *)handle);
+}
+
+static void flush_windows(void)
+{
+	doupdate();
+}
+
+static void get_size(uint16_t *rows, uint16_t *cols)
+{
+	int max_y, max_x;
+
+	getmaxyx(stdscr, max_y, max_x);
+	*rows = max_y;
+	*cols = max_x;
+}
\ No newline at end of file
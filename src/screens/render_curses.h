@@ -0,0 +1,10 @@
+#ifndef RENDER_CURSES_H
+#define RENDER_CURSES_H
+
+#include "render.h"
+
+// render windows are curses windows, flush is a doupdate. Curses has to be
+// initialized (initscr) before any window is created
+const render_backend_t *render_curses_get_backend(void);
+
+#endif
\ No newline at end of file
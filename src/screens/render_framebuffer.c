@@ -0,0 +1,236 @@
+#include "render_framebuffer.h"
+#include "../data_structures/memory.h"
+
+// the line drawing characters (A_ALTCHARSET) and their unicode look alike
+#define RENDER_FRAMEBUFFER_ACS_CHARS "lkmjtuvwnqx0a~`"
+
+static const char *c_acs_glyphs[] = { "┌", "┐", "└", "┘", "├", "┤", "┴", "┬", "┼", "─", "│", "█", "▒", "·", "◆" };
+
+typedef struct framebuffer_window_t
+{
+	chtype	*cells;
+	bool	*dirty_rows; // drawn since the last submit
+	uint16_t rows;
+	uint16_t cols;
+	uint16_t y;
+	uint16_t x;
+} framebuffer_window_t;
+
+static render_framebuffer_t framebuffer;
+
+static void *create_window(uint16_t rows, uint16_t cols, uint16_t y, uint16_t x);
+static void	 destroy_window(void *handle);
+static void	 erase_window(void *handle);
+static void	 draw_cells(void *handle, uint16_t y, uint16_t x, const chtype *cells, uint16_t count);
+static void	 touch_window(void *handle);
+static void	 submit_window(void *handle);
+static void	 flush_windows(void);
+static void	 get_size(uint16_t *rows, uint16_t *cols);
+static void	 init_acs(void);
+
+static const render_backend_t c_backend = {
+	.name			= "framebuffer",
+	.create_window	= &create_window,
+	.destroy_window = &destroy_window,
+	.erase_window	= &erase_window,
+	.draw_cells		= &draw_cells,
+	.touch_window	= &touch_window,
+	.submit_window	= &submit_window,
+	.flush_windows	= &flush_windows,
+	.get_size		= &get_size,
+};
+
+const render_backend_t *render_framebuffer_init(uint16_t rows, uint16_t cols)
+{
+	memset(&framebuffer, 0, sizeof(framebuffer));
+
+	framebuffer.rows	   = rows;
+	framebuffer.cols	   = cols;
+	framebuffer.cells	   = (chtype *)memory_alloc(rows * cols * sizeof(chtype));
+	framebuffer.next_cells = (chtype *)memory_alloc(rows * cols * sizeof(chtype));
+	ASSERT(framebuffer.cells && framebuffer.next_cells);
+
+	for (uint32_t i = 0; i < (uint32_t)(rows * cols); i++)
+	{
+		framebuffer.cells[i]	  = ' ';
+		framebuffer.next_cells[i] = ' ';
+	}
+
+	init_acs();
+
+	return &c_backend;
+}
+
+void render_framebuffer_dispose(void)
+{
+	memory_free(framebuffer.cells);
+	memory_free(framebuffer.next_cells);
+	memset(&framebuffer, 0, sizeof(framebuffer));
+}
+
+const render_framebuffer_t *render_framebuffer_get(void)
+{
+	return &framebuffer;
+}
+
+// cells that differ between two frames
+uint32_t render_framebuffer_diff(const chtype *cells, const chtype *prev_cells, uint32_t count)
+{
+	uint32_t changed = 0;
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		changed += cells[i] != prev_cells[i];
+	}
+
+	return changed;
+}
+
+// the current frame as utf-8 text, a line per row without trailing spaces.
+// Attributes (colors) are dropped
+bool render_framebuffer_write_text(FILE *f)
+{
+	for (uint16_t y = 0; y < framebuffer.rows; y++)
+	{
+		const chtype *row	= &framebuffer.cells[framebuffer.cols * y];
+		uint16_t	  width = framebuffer.cols;
+
+		while (width > 0 && (row[width - 1] & A_CHARTEXT) == ' ' && !(row[width - 1] & A_ALTCHARSET))
+		{
+			width--;
+		}
+
+		for (uint16_t x = 0; x < width; x++)
+		{
+			char		ch	  = row[x] & A_CHARTEXT;
+			const char *glyph = (row[x] & A_ALTCHARSET) && ch ? strchr(RENDER_FRAMEBUFFER_ACS_CHARS, ch) : NULL;
+
+			if (glyph)
+			{
+				fputs(c_acs_glyphs[glyph - RENDER_FRAMEBUFFER_ACS_CHARS], f);
+			}
+			else
+			{
+				fputc(ch >= ' ' && ch < 127 ? ch : '?', f);
+			}
+		}
+
+		fputc('\n', f);
+	}
+
+	return !ferror(f);
+}
+
+static void *create_window(uint16_t rows, uint16_t cols, uint16_t y, uint16_t x)
+{
+	framebuffer_window_t *win = (framebuffer_window_t *)memory_alloc(sizeof(framebuffer_window_t));
+
+	if (!win)
+	{
+		return NULL;
+	}
+
+	win->rows		= rows;
+	win->cols		= cols;
+	win->y			= y;
+	win->x			= x;
+	win->cells		= (chtype *)memory_alloc(rows * cols * sizeof(chtype));
+	win->dirty_rows = (bool *)memory_alloc(rows * sizeof(bool));
+
+	if (!win->cells || !win->dirty_rows)
+	{
+		destroy_window(win);
+		return NULL;
+	}
+
+	erase_window(win);
+
+	return win;
+}
+
+static void destroy_window(void *handle)
+{
+	framebuffer_window_t *win = (framebuffer_window_t *)handle;
+
+	memory_free(win->cells);
+	memory_free(win->dirty_rows);
+	memory_free(win);
+}
+
+static void erase_window(void *handle)
+{
+	framebuffer_window_t *win = (framebuffer_window_t *)handle;
+
+	for (uint32_t i = 0; i < (uint32_t)(win->rows * win->cols); i++)
+	{
+		win->cells[i] = ' ';
+	}
+
+	touch_window(win);
+}
+
+static void draw_cells(void *handle, uint16_t y, uint16_t x, const chtype *cells, uint16_t count)
+{
+	framebuffer_window_t *win = (framebuffer_window_t *)handle;
+
+	memcpy(&win->cells[win->cols * y + x], cells, count * sizeof(chtype));
+	win->dirty_rows[y] = true;
+}
+
+static void touch_window(void *handle)
+{
+	framebuffer_window_t *win = (framebuffer_window_t *)handle;
+
+	memset(win->dirty_rows, true, win->rows * sizeof(bool));
+}
+
+// the part of the window out of the screen is cut
+static void submit_window(void *handle)
+{
+	framebuffer_window_t *win	= (framebuffer_window_t *)handle;
+	uint16_t			  width = win->x >= framebuffer.cols ? 0 : framebuffer.cols - win->x;
+
+	width = win->cols < width ? win->cols : width;
+
+	for (uint16_t y = 0; y < win->rows && win->y + y < framebuffer.rows; y++)
+	{
+		if (win->dirty_rows[y])
+		{
+			memcpy(&framebuffer.next_cells[framebuffer.cols * (win->y + y) + win->x], &win->cells[win->cols * y], width * sizeof(chtype));
+			win->dirty_rows[y] = false;
+		}
+	}
+}
+
+static void flush_windows(void)
+{
+	uint32_t count = framebuffer.rows * framebuffer.cols;
+
+	framebuffer.cells_changed = render_framebuffer_diff(framebuffer.next_cells, framebuffer.cells, count);
+	framebuffer.frames++;
+	memcpy(framebuffer.cells, framebuffer.next_cells, count * sizeof(chtype));
+}
+
+static void get_size(uint16_t *rows, uint16_t *cols)
+{
+	*rows = framebuffer.rows;
+	*cols = framebuffer.cols;
+}
+
+// curses fills the line drawing characters in (ACS_*) when initialized,
+// they're all 0 until then. Without it, they're the vt100 ones, as curses'
+// own defaults
+static void init_acs(void)
+{
+#ifdef NCURSES_VERSION
+	if (acs_map['q'] != 0)
+	{
+		return;
+	}
+
+	for (const char *ch = RENDER_FRAMEBUFFER_ACS_CHARS; *ch; ch++)
+	{
+		acs_map[(unsigned char)*ch] = (unsigned char)*ch | A_ALTCHARSET;
+	}
+#endif
+}
\ No newline at end of file
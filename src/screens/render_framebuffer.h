@@ -0,0 +1,26 @@
+#ifndef RENDER_FRAMEBUFFER_H
+#define RENDER_FRAMEBUFFER_H
+
+#include "render.h"
+
+// a screen in memory, to render without a terminal (benchmarks, frame
+// diffs, screenshots), curses doesn't need to be initialized. Windows keep
+// their own cells, submit copies the rows drawn since to the next frame and
+// flush makes it the current one, as doupdate would send it
+typedef struct render_framebuffer_t
+{
+	chtype	*cells;		 // current frame, rows * cols
+	chtype	*next_cells; // being submitted
+	uint16_t rows;
+	uint16_t cols;
+	uint32_t frames;		// flushes
+	uint32_t cells_changed; // by the last flush, what a terminal would be sent
+} render_framebuffer_t;
+
+const render_backend_t	   *render_framebuffer_init(uint16_t rows, uint16_t cols);
+void						render_framebuffer_dispose(void);
+const render_framebuffer_t *render_framebuffer_get(void);
+uint32_t					render_framebuffer_diff(const chtype *cells, const chtype *prev_cells, uint32_t count);
+bool						render_framebuffer_write_text(FILE *f);
+
+#endif
\ No newline at end of file
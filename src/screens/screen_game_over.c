@@ -1,10 +1,16 @@
 #include "screen_game_over.h"
+#include "../assets.h"
 #include "../common.h"
+#include "../input.h"
+#include "../score_store.h"
+#include "ascii_art.h"
+#include "compositor.h"
+#include "screen_utils.h"
 
-extern int		 g_key;
-extern float32_t g_delta_time;
-extern char		*g_asset_game_over;
-extern score_t	 g_score;
+extern float32_t	  g_delta_time;
+extern const asset_t *g_asset_game_over;
+extern score_t		  g_score;
+extern arena_t		  g_screens_arena;
 
 static const uint8_t  c_win_game_over_width		   = 51;
 static const uint8_t  c_win_game_over_height	   = 6;
@@ -13,13 +19,18 @@ static const uint8_t  c_win_new_record_height	   = 3;
 static const uint8_t  c_win_play_again_width	   = 51;
 static const uint8_t  c_win_play_again_height	   = 3;
 static const uint32_t c_record_points_acceleration = 1;
+static const char	 *c_label_save_failed		   = "The game couldn't be saved";
 
-static WINDOW *win_game_over;
-static WINDOW *win_new_record;
-static WINDOW *win_play_again;
+static render_window_t win_game_over;
+static render_window_t win_new_record;
+static render_window_t win_play_again;
+static ascii_art_t	   game_over_art;
 
 static bool		 key_enter_pressed		 = false;
 static bool		 render_play_again_label = true;
+static bool		 play_again_label_drawn	 = false; // what win_play_again shows
+static bool		 save_failed			 = false; // the game, written in the background
+static bool		 save_failed_drawn		 = false;
 static float32_t elapsed_time			 = 0;
 static uint32_t	 record_points			 = 0;
 static uint32_t	 record_points_velocity	 = 0;
@@ -28,41 +39,50 @@ static void render_game_over(void);
 static void render_new_record(void);
 static void render_play_again(void);
 
-void screen_game_over_init(void)
+void screen_game_over_create(void)
 {
-	uint8_t offset_y, offset_x;
+	uint16_t offset_y, offset_x;
 
 	set_offset_yx(c_win_game_over_height + c_win_new_record_height + c_win_play_again_height, c_win_game_over_width, &offset_y, &offset_x);
-	win_game_over = newwin(c_win_game_over_height, c_win_game_over_width, offset_y, offset_x);
-	scrollok(win_game_over, TRUE);
+	win_game_over = render_window_new(c_win_game_over_height, c_win_game_over_width, offset_y, offset_x);
+
+	win_new_record = render_window_new(c_win_new_record_height, c_win_new_record_width, offset_y + c_win_game_over_height, offset_x);
 
-	win_new_record = newwin(c_win_new_record_height, c_win_new_record_width, offset_y + c_win_game_over_height, offset_x);
-	scrollok(win_new_record, TRUE);
+	win_play_again = render_window_new(c_win_play_again_height, c_win_play_again_width, offset_y + c_win_game_over_height + c_win_new_record_height, offset_x);
 
-	win_play_again = newwin(c_win_play_again_height, c_win_play_again_width, offset_y + c_win_game_over_height + c_win_new_record_height, offset_x);
-	scrollok(win_play_again, TRUE);
+	game_over_art = ascii_art_new(&g_screens_arena, g_asset_game_over, COLOR_PAIR(COLOR_PAIR_RED_DEFAULT));
+}
 
+void screen_game_over_destroy(void)
+{
+	render_window_dispose(&win_game_over);
+	render_window_dispose(&win_new_record);
+	render_window_dispose(&win_play_again);
+}
+
+void screen_game_over_init(void)
+{
 	key_enter_pressed	   = false;
 	elapsed_time		   = 0;
 	record_points		   = 0;
 	record_points_velocity = 1;
+	play_again_label_drawn = false;
+	save_failed			   = false;
+	save_failed_drawn	   = false;
 
 	render_game_over();
 }
 
 void screen_game_over_dispose(void)
 {
-	wclear(win_game_over);
-	wrefresh(win_game_over);
-	delwin(win_game_over);
+	render_erase(&win_game_over);
+	compositor_submit(&win_game_over);
 
-	wclear(win_new_record);
-	wrefresh(win_new_record);
-	delwin(win_new_record);
+	render_erase(&win_new_record);
+	compositor_submit(&win_new_record);
 
-	wclear(win_play_again);
-	wrefresh(win_play_again);
-	delwin(win_play_again);
+	render_erase(&win_play_again);
+	compositor_submit(&win_play_again);
 }
 
 bool screen_game_over_is_completed(void)
@@ -73,8 +93,9 @@ bool screen_game_over_is_completed(void)
 void screen_game_over_update(void)
 {
 	elapsed_time += g_delta_time;
-	key_enter_pressed		= key_enter_pressed || g_key == CH_ENTER;
+	key_enter_pressed		= key_enter_pressed || input_key_pressed(CH_ENTER);
 	render_play_again_label = (uint32_t)(elapsed_time) % 2;
+	save_failed				= score_store_get_status() == SCORE_STORE_STATUS_FAILED;
 
 	if (g_score.current >= g_score.record && record_points < g_score.current)
 	{
@@ -95,7 +116,22 @@ void screen_game_over_render(void)
 		render_new_record();
 	}
 
-	render_play_again();
+	if (render_play_again_label != play_again_label_drawn || save_failed != save_failed_drawn)
+	{
+		render_play_again();
+	}
+}
+
+// new record points count up every frame, otherwise only the play again
+// label blinks every second
+float32_t screen_game_over_next_wakeup(void)
+{
+	if (key_enter_pressed || (g_score.current >= g_score.record && record_points < g_score.current))
+	{
+		return 0;
+	}
+
+	return 1 - fmod(elapsed_time, 1);
 }
 
 void screen_game_over_window_resized(void)
@@ -105,50 +141,39 @@ void screen_game_over_window_resized(void)
 
 static void render_game_over(void)
 {
-	uint32_t i = 0;
-	uint8_t	 ch,
-		x = 0,
-		y = 0;
-
-	werase(win_game_over);
-	wattron(win_game_over, COLOR_PAIR(COLOR_PAIR_RED_DEFAULT));
-
-	while ((ch = g_asset_game_over[i++]) != CH_EOS)
-	{
-		if (ch == CH_EOL)
-		{
-			x = 0;
-			y++;
-			continue;
-		}
-
-		mvwprintw(win_game_over, y, x++, "%c", ch);
-	}
-
-	wattroff(win_game_over, COLOR_PAIR(COLOR_PAIR_RED_DEFAULT));
-	wrefresh(win_game_over);
+	render_erase(&win_game_over);
+	ascii_art_draw(&game_over_art, &win_game_over);
+	compositor_submit(&win_game_over);
 }
 
 static void render_new_record(void)
 {
 	char record[30] = { '\0' };
-	wclear(win_new_record);
+	render_erase(&win_new_record);
 
 	sprintf(record, "New record! %d", record_points);
 
-	wrefresh(win_new_record);
+	compositor_submit(&win_new_record);
 }
 
 static void render_play_again(void)
 {
 	uint8_t offset_x;
-	werase(win_play_again);
+	render_erase(&win_play_again);
 
 	if (render_play_again_label)
 	{
 		offset_x = (c_win_play_again_width - 25) * 0.5;
-		mvwprintw(win_play_again, 2, offset_x, "Press enter to play again");
+		render_text(&win_play_again, 2, offset_x, 0, "Press enter to play again");
+	}
+
+	if (save_failed)
+	{
+		offset_x = (c_win_play_again_width - strlen(c_label_save_failed)) * 0.5;
+		render_text(&win_play_again, 0, offset_x, COLOR_PAIR(COLOR_PAIR_RED_DEFAULT), "%s", c_label_save_failed);
 	}
 
-	wrefresh(win_play_again);
+	play_again_label_drawn = render_play_again_label;
+	save_failed_drawn	   = save_failed;
+	compositor_submit(&win_play_again);
 }
\ No newline at end of file
@@ -3,11 +3,14 @@
 
 #include "../defs.h"
 
-void screen_game_over_init(void);
-void screen_game_over_dispose(void);
-bool screen_game_over_is_completed(void);
-void screen_game_over_update(void);
-void screen_game_over_render(void);
-void screen_game_over_window_resized(void);
+void		screen_game_over_create(void);
+void		screen_game_over_destroy(void);
+void		screen_game_over_init(void);
+void		screen_game_over_dispose(void);
+bool		screen_game_over_is_completed(void);
+void		screen_game_over_update(void);
+void		screen_game_over_render(void);
+float32_t	screen_game_over_next_wakeup(void);
+void		screen_game_over_window_resized(void);
 
 #endif
\ No newline at end of file
@@ -1,12 +1,17 @@
 #include "screen_init.h"
+#include "../assets.h"
 #include "../common.h"
+#include "../input.h"
+#include "ascii_art.h"
+#include "compositor.h"
+#include "screen_utils.h"
 
 #define ASSET_SPLASH_SECOND_SECTION_ROW_INDEX 4
 #define ASSET_SPLASH_THIRD_SECTION_ROW_INDEX 10
 
-extern char		*g_asset_splash;
-extern int		 g_key;
-extern float32_t g_delta_time;
+extern const asset_t *g_asset_splash;
+extern float32_t	  g_delta_time;
+extern arena_t		  g_screens_arena;
 
 static const char	*c_label_start			  = "Press ENTER to start";
 static const uint8_t c_win_splash_width		  = 27;
@@ -15,39 +20,52 @@ static const uint8_t c_win_actions_width	  = 20;
 static const uint8_t c_win_actions_height	  = 2;
 static const uint8_t c_win_actions_margin_top = 2;
 
-static WINDOW	*win_splash;
-static WINDOW	*win_actions;
-static bool		 print_label_start = true;
-static bool		 key_enter_pressed = false;
-static float32_t elapsed_time	   = 0;
+static render_window_t win_splash;
+static render_window_t win_actions;
+static ascii_art_t	   splash_art;
+static bool			   print_label_start = true;
+static bool			   label_start_drawn = false; // what win_actions shows
+static bool			   key_enter_pressed = false;
+static float32_t	   elapsed_time		 = 0;
 
 static void render_splash(void);
 static void render_actions(void);
 
-void screen_init_init(void)
+void screen_init_create(void)
 {
-	uint8_t offset_y, offset_y2, offset_x;
+	uint16_t offset_y, offset_y2, offset_x;
 
 	set_offset_yx(c_win_splash_height, c_win_splash_width, &offset_y, &offset_x);
-	win_splash = newwin(c_win_splash_height, c_win_splash_width, offset_y, offset_x);
-	scrollok(win_splash, TRUE);
+	win_splash = render_window_new(c_win_splash_height, c_win_splash_width, offset_y, offset_x);
 
 	set_offset_yx(c_win_actions_height, c_win_actions_width, &offset_y2, &offset_x);
-	win_actions = newwin(c_win_actions_height, c_win_actions_width, offset_y + c_win_splash_height + c_win_actions_margin_top, offset_x);
-	scrollok(win_actions, TRUE);
+	win_actions = render_window_new(c_win_actions_height, c_win_actions_width, offset_y + c_win_splash_height + c_win_actions_margin_top, offset_x);
+
+	splash_art = ascii_art_new(&g_screens_arena, g_asset_splash, COLOR_PAIR(COLOR_PAIR_YELLOW_DEFAULT));
+	ascii_art_set_attrs(&splash_art, ASSET_SPLASH_SECOND_SECTION_ROW_INDEX, COLOR_PAIR(COLOR_PAIR_RED_DEFAULT));
+	ascii_art_set_attrs(&splash_art, ASSET_SPLASH_THIRD_SECTION_ROW_INDEX, COLOR_PAIR(COLOR_PAIR_GREEN_DEFAULT));
+}
+
+void screen_init_destroy(void)
+{
+	render_window_dispose(&win_splash);
+	render_window_dispose(&win_actions);
+}
+
+void screen_init_init(void)
+{
+	label_start_drawn = false;
 
 	render_splash();
 }
 
 void screen_init_dispose(void)
 {
-	wclear(win_splash);
-	wrefresh(win_splash);
-	delwin(win_splash);
+	render_erase(&win_splash);
+	compositor_submit(&win_splash);
 
-	wclear(win_actions);
-	wrefresh(win_actions);
-	delwin(win_actions);
+	render_erase(&win_actions);
+	compositor_submit(&win_actions);
 }
 
 bool screen_init_is_completed(void)
@@ -58,61 +76,54 @@ bool screen_init_is_completed(void)
 void screen_init_update(void)
 {
 	elapsed_time += g_delta_time;
-	key_enter_pressed = key_enter_pressed || g_key == CH_ENTER;
+	key_enter_pressed = key_enter_pressed || input_key_pressed(CH_ENTER);
 	print_label_start = !key_enter_pressed && (uint32_t)(elapsed_time) % 2;
 }
 
+// the splash doesn't change, only the start label is redrawn when it blinks
 void screen_init_render(void)
 {
-	render_splash();
-	render_actions();
+	if (print_label_start != label_start_drawn)
+	{
+		render_actions();
+	}
 }
 
-static void render_splash(void)
+// the start label blinks every second
+float32_t screen_init_next_wakeup(void)
 {
-	uint32_t i = 0;
-	uint8_t	 ch,
-		x = 0,
-		y = 0;
-
-	werase(win_splash);
-	wattron(win_splash, COLOR_PAIR(COLOR_PAIR_YELLOW_DEFAULT));
-
-	while ((ch = g_asset_splash[i++]) != CH_EOS)
+	if (key_enter_pressed)
 	{
-		if (ch == CH_EOL)
-		{
-			x = 0;
-			y++;
-			continue;
-		}
-
-		if (y == ASSET_SPLASH_SECOND_SECTION_ROW_INDEX)
-		{
-			wattroff(win_splash, COLOR_PAIR(COLOR_PAIR_YELLOW_DEFAULT));
-			wattron(win_splash, COLOR_PAIR(COLOR_PAIR_RED_DEFAULT));
-		}
-		else if (y == ASSET_SPLASH_THIRD_SECTION_ROW_INDEX)
-		{
-			wattroff(win_splash, COLOR_PAIR(COLOR_PAIR_RED_DEFAULT));
-			wattron(win_splash, COLOR_PAIR(COLOR_PAIR_GREEN_DEFAULT));
-		}
-
-		mvwprintw(win_splash, y, x++, "%c", ch);
+		return 0;
 	}
 
-	wattroff(win_splash, COLOR_PAIR(COLOR_PAIR_RED_DEFAULT));
-	wrefresh(win_splash);
+	return 1 - fmod(elapsed_time, 1);
+}
+
+void screen_init_window_resized(void)
+{
+	render_touch(&win_splash);
+	compositor_submit(&win_splash);
+	render_touch(&win_actions);
+	compositor_submit(&win_actions);
+}
+
+static void render_splash(void)
+{
+	render_erase(&win_splash);
+	ascii_art_draw(&splash_art, &win_splash);
+	compositor_submit(&win_splash);
 }
 
 void render_actions(void)
 {
-	wclear(win_actions);
+	render_erase(&win_actions);
 
 	if (print_label_start)
 	{
-		mvwprintw(win_actions, 0, 0, "%s", c_label_start);
+		render_text(&win_actions, 0, 0, 0, "%s", c_label_start);
 	}
 
-	wrefresh(win_actions);
+	label_start_drawn = print_label_start;
+	compositor_submit(&win_actions);
 }
\ No newline at end of file
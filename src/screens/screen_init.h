@@ -3,10 +3,14 @@
 
 #include "../defs.h"
 
-void screen_init_init(void);
-void screen_init_dispose(void);
-bool screen_init_is_completed(void);
-void screen_init_update(void);
-void screen_init_render(void);
+void		screen_init_create(void);
+void		screen_init_destroy(void);
+void		screen_init_init(void);
+void		screen_init_dispose(void);
+bool		screen_init_is_completed(void);
+void		screen_init_update(void);
+void		screen_init_render(void);
+float32_t	screen_init_next_wakeup(void);
+void		screen_init_window_resized(void);
 
 #endif
\ No newline at end of file
@@ -1,68 +1,79 @@
 #include "screen_stage.h"
+#include "../broadcast.h"
 #include "../common.h"
-#include "../data_structures/data_structures.h"
-#include "../shapes.h"
+#include "../engine/bot.h"
+#include "../engine/engine.h"
+#include "../engine/replay.h"
+#include "../input.h"
+#include "../profile.h"
+#include "../score_store.h"
+#include "cell_buffer.h"
+#include "compositor.h"
+#include "screen_utils.h"
+#include "stage_draw.h"
+
+extern score_t		g_score;
+extern float32_t	g_delta_time;
+extern bool			g_bot;
+extern bool			g_bag;
+extern char		   *g_record_file;
+extern board_size_t g_board_size;
+extern arena_t		g_screens_arena;
 
-extern int		 g_key;
-extern score_t	 g_score;
-extern float32_t g_delta_time;
-
-#define BOARD_ROWS 20
-#define BOARD_COLS 10
-
-typedef enum player_action_t
-{
-	PLAYER_ACTION_IDLE		 = 0,
-	PLAYER_ACTION_MOVE_LEFT	 = 1,
-	PLAYER_ACTION_MOVE_RIGHT = 2,
-	PLAYER_ACTION_ROTATE	 = 3,
-	PLAYER_ACTION_SPEEDUP	 = 4,
-	PLAYER_ACTION_HARD_DROP	 = 5
-} player_action_t;
-
-static const uint8_t c_win_board_width		 = 22;
-static const uint8_t c_win_board_height		 = 22;
 static const uint8_t c_win_next_shape_width	 = 20;
 static const uint8_t c_win_next_shape_height = 11;
 static const uint8_t c_win_score_width		 = 20;
 static const uint8_t c_win_score_height		 = 11;
 static const uint8_t c_win_paused_width		 = 30;
 static const uint8_t c_win_paused_height	 = 10;
-static const uint8_t c_win_pause_hint_width	 = c_win_board_width + c_win_next_shape_width;
 static const uint8_t c_win_pause_hint_height = 2;
 
 static const uint8_t   c_win_padding					= 1;
 static const uint8_t   c_score_velocity					= 30;
-static const uint8_t   c_speedup_velocity				= 20;
-static const uint8_t   c_max_level						= 10;
-static const float32_t c_shape_base_velocity			= 1; // 1 row per second
-static const float32_t c_filled_rows_animation_lifetime = 0.3;
-static const float32_t c_prev_shape_animation_lifetime	= 0.3;
 static const float32_t c_game_over_filled_rows_velocity = 0.05;
 
-static WINDOW *win_board;
-static WINDOW *win_next_shape;
-static WINDOW *win_score;
-static WINDOW *win_paused;
-static WINDOW *win_pause_hint;
-
-static uint8_t board[BOARD_ROWS * BOARD_COLS];
-static shape_t next_shape;
-static shape_t current_shape;
-static shape_t prev_shape;
-
-static float32_t	current_shape_elapsed_time;
-static uint8_t		player_action;
-static uint8_t		level;
-static uint8_t		velocity;
-static uint8_t		board_top_row_filled;
-static sparse_set_t filled_rows_indexes;
-static float32_t	filled_rows_elapsed_time;
-static float32_t	prev_shape_elapsed_time;
-static uint8_t		game_over_filled_rows;
-static float32_t	game_over_filled_rows_elapsed_time;
-
-static bool shape_shadow_enabled;
+#ifdef PROFILE
+static const uint8_t   c_win_profile_width	   = 46;
+static const uint8_t   c_win_profile_height	   = 12;
+static const float32_t c_win_profile_interval = 0.25; // readable, and cheaper than every frame
+
+static render_window_t win_profile;
+static bool			   profile_visible;
+static float32_t	   profile_elapsed_time;
+#endif
+
+static render_window_t win_board;
+static render_window_t win_next_shape;
+static render_window_t win_score;
+static render_window_t win_paused;
+static render_window_t win_pause_hint;
+
+static cell_buffer_t board_cells;
+static cell_buffer_t next_shape_cells;
+static vec2i_t		 board_view; // top left cell shown, boards larger than the window scroll
+
+// values currently shown on the next shape and score windows
+static struct
+{
+	uint16_t current_label;
+	uint16_t record_label;
+	uint8_t	 level;
+	uint8_t	 next_shape_type;
+	bool	 valid;
+} hud;
+
+static engine_t	 engine;
+static bot_t	 bot;
+static replay_t	 replay;
+static bool		 bot_enabled;
+static float32_t delta_time_remainder; // lost rounding to replay delta times
+static uint32_t	 seed;
+static uint32_t	 game_time_ms; // played, pauses excluded
+static uint8_t	 player_actions[INPUT_KEYS_CAPACITY];
+static uint8_t	 player_actions_count;
+static uint16_t	 game_over_filled_rows;
+static float32_t game_over_filled_rows_elapsed_time;
+
 static bool paused;
 static bool win_paused_active;
 
@@ -70,32 +81,43 @@ static bool win_paused_active;
 static void create_windows(void);
 // UPDATE
 static void handle_input(void);
-static void update_current_shape(void);
-static void rotate_shape(bool backward);
-static void set_shape_padding(shape_t *shape);
-static void drop_shape(void);
-static void handle_collision(void);
-static void set_shape_on_board(void);
-static void scan_board_filled_rows(void);
-static void process_board_filled_rows(void);
 static void process_game_over_filled_rows(void);
-static void process_prev_shape_animation(void);
-static void set_prev_shape(void);
-static void set_next_shape(void);
-static void set_current_shape(void);
+static void update_score(void);
 static void save_score(void);
 static void update_score_labels(void);
-
-static uint8_t get_shape_dest_pos_y(void);
+static void step_engine(player_action_t action, float32_t delta_time);
 // RENDER
+static void render_windows(void);
 static void render_win_board(void);
 static void render_win_next_shape(void);
 static void render_win_score(void);
 static void render_win_paused(void);
-static void render_win_pause_hint(void);
-static void render_shape(WINDOW *win, shape_t *shape, bool shadow);
-static void render_board(void);
+static void publish_frame(void);
+#ifdef PROFILE
+static void render_win_profile(void);
+#endif
+
+void screen_stage_create(void)
+{
+	create_windows();
+}
+
+void screen_stage_destroy(void)
+{
+	render_window_dispose(&win_board);
+	render_window_dispose(&win_next_shape);
+	render_window_dispose(&win_score);
+	render_window_dispose(&win_paused);
+	render_window_dispose(&win_pause_hint);
+#ifdef PROFILE
+	render_window_dispose(&win_profile);
+#endif
+
+	cell_buffer_dispose(&board_cells);
+	cell_buffer_dispose(&next_shape_cells);
+}
 
+// a new game on the windows as they were left by dispose (erased)
 void screen_stage_init(void)
 {
 	g_score.current		  = 0;
@@ -104,22 +126,35 @@ void screen_stage_init(void)
 
 	paused							   = false;
 	win_paused_active				   = false;
-	player_action					   = PLAYER_ACTION_IDLE;
-	level							   = 1;
-	current_shape_elapsed_time		   = 0;
-	board_top_row_filled			   = BOARD_ROWS - 1;
-	filled_rows_indexes				   = sparse_set_new(BOARD_ROWS);
+	player_actions_count			   = 0;
 	game_over_filled_rows			   = 0;
 	game_over_filled_rows_elapsed_time = 0;
 
-	memset(board, 0, sizeof(uint8_t) * (BOARD_ROWS * BOARD_COLS));
+	randomizer_type_t randomizer_type = g_bag ? RANDOMIZER_TYPE_BAG : RANDOMIZER_TYPE_UNIFORM;
+	seed							  = time(NULL);
+	game_time_ms					  = 0;
+	delta_time_remainder			  = 0;
 
-	srand(time(NULL));
-	create_windows();
-	set_next_shape();
-	set_current_shape();
-	set_next_shape();
+	engine_init(&engine, seed, randomizer_type, g_board_size);
+	board_view = (vec2i_t){ 0 };
+
+	// each game overwrites the previous one
+	if (g_record_file)
+	{
+		replay_create(&replay, g_record_file, seed, randomizer_type, g_board_size);
+	}
+
+	bot_init(&bot);
+	bot_enabled = g_bot;
+	broadcast_reset();
 
+	cell_buffer_invalidate(&board_cells);
+	cell_buffer_invalidate(&next_shape_cells);
+#ifdef PROFILE
+	profile_elapsed_time = c_win_profile_interval;
+#endif
+
+	render_windows();
 	render_win_board();
 	render_win_next_shape();
 	render_win_score();
@@ -128,47 +163,55 @@ void screen_stage_init(void)
 void screen_stage_dispose(void)
 {
 	save_score();
-	wclear(win_board);
-	wrefresh(win_board);
-	delwin(win_board);
+	render_erase(&win_board);
+	compositor_submit(&win_board);
+
+	render_erase(&win_next_shape);
+	compositor_submit(&win_next_shape);
 
-	wclear(win_next_shape);
-	wrefresh(win_next_shape);
-	delwin(win_next_shape);
+	render_erase(&win_score);
+	compositor_submit(&win_score);
 
-	wclear(win_score);
-	wrefresh(win_score);
-	delwin(win_score);
+	render_erase(&win_paused);
+	compositor_submit(&win_paused);
 
-	wclear(win_paused);
-	wrefresh(win_paused);
-	delwin(win_paused);
+	render_erase(&win_pause_hint);
+	compositor_submit(&win_pause_hint);
 
-	wclear(win_pause_hint);
-	wrefresh(win_pause_hint);
-	delwin(win_pause_hint);
+#ifdef PROFILE
+	render_erase(&win_profile);
+	compositor_submit(&win_profile);
+#endif
 
-	sparse_set_dispose(&filled_rows_indexes);
+	if (g_record_file)
+	{
+		replay_close(&replay, &engine);
+	}
+
+	engine_dispose(&engine);
 }
 
 bool screen_stage_is_completed(void)
 {
-	return board_top_row_filled == 0 && game_over_filled_rows >= BOARD_ROWS;
+	return engine_is_game_over(&engine) && game_over_filled_rows >= board_cells.rows;
 }
 
 void screen_stage_update(void)
 {
-	if (board_top_row_filled > 0)
+	if (!engine_is_game_over(&engine))
 	{
-		velocity = level;
 		handle_input();
 
 		if (!paused)
 		{
-			update_current_shape();
-			handle_collision();
-			process_board_filled_rows();
-			process_prev_shape_animation();
+			// every key of the frame is applied, in order, before time moves on
+			for (uint8_t i = 0; i < player_actions_count; i++)
+			{
+				step_engine(player_actions[i], 0);
+			}
+
+			step_engine(PLAYER_ACTION_IDLE, g_delta_time);
+			update_score();
 			update_score_labels();
 		}
 	}
@@ -176,6 +219,11 @@ void screen_stage_update(void)
 	{
 		process_game_over_filled_rows();
 	}
+
+#ifdef PROFILE
+	PROFILE_COUNT(PROFILE_COUNTER_COLLISIONS, engine.collision_checks);
+	engine.collision_checks = 0;
+#endif
 }
 
 void screen_stage_render(void)
@@ -188,426 +236,173 @@ void screen_stage_render(void)
 	{
 		render_win_next_shape();
 		render_win_score();
-		render_win_pause_hint();
-
-		werase(win_board);
 		render_win_board();
-		render_shape(win_board, &current_shape, shape_shadow_enabled);
-		render_board();
-		wrefresh(win_board);
-	}
-}
-
-void screen_stage_window_resized(void)
-{
-	render_win_next_shape();
-	render_win_score();
-	render_win_pause_hint();
-
-	werase(win_board);
-	render_win_board();
-	render_shape(win_board, &current_shape, shape_shadow_enabled);
-	render_board();
-	wrefresh(win_board);
-
-	if (paused)
-	{
-		render_win_paused();
 	}
-}
-
-// UPDATE
-static void create_windows(void)
-{
-	uint8_t offset_y, offset_x;
-
-	set_offset_yx(c_win_board_height + c_win_pause_hint_height, c_win_board_width + c_win_next_shape_width, &offset_y, &offset_x);
-	win_board = newwin(c_win_board_height, c_win_board_width, offset_y, offset_x);
-	scrollok(win_board, TRUE);
-
-	win_next_shape = newwin(c_win_next_shape_height, c_win_next_shape_width, offset_y, offset_x + c_win_board_width);
-	scrollok(win_next_shape, TRUE);
 
-	win_score = newwin(c_win_score_height, c_win_score_width, offset_y + c_win_next_shape_height, offset_x + c_win_board_width);
-	scrollok(win_score, TRUE);
+#ifdef PROFILE
+	render_win_profile();
+#endif
 
-	win_pause_hint = newwin(c_win_pause_hint_height, c_win_pause_hint_width, offset_y + c_win_board_height, offset_x);
-	scrollok(win_pause_hint, TRUE);
-
-	set_offset_yx(c_win_paused_height, c_win_paused_width, &offset_y, &offset_x);
-	win_paused = newwin(c_win_paused_height, c_win_paused_width, offset_y, offset_x);
-	scrollok(win_paused, TRUE);
-}
-
-static void handle_input(void)
-{
-	player_action = PLAYER_ACTION_IDLE;
-
-	if (g_key > 0)
+	if (broadcast_is_running())
 	{
-		if (g_key == CH_LEFT)
-		{
-			player_action = PLAYER_ACTION_MOVE_LEFT;
-		}
-		else if (g_key == CH_RIGHT)
-		{
-			player_action = PLAYER_ACTION_MOVE_RIGHT;
-		}
-		else if (g_key == CH_UP)
-		{
-			player_action = PLAYER_ACTION_ROTATE;
-		}
-		else if (g_key == CH_DOWN && level < c_speedup_velocity)
-		{
-			player_action = PLAYER_ACTION_SPEEDUP;
-		}
-		else if (g_key == CH_SPACE)
-		{
-			player_action = PLAYER_ACTION_HARD_DROP;
-		}
-		else if (g_key == CH_PAUSE_L || g_key == CH_PAUSE_U)
-		{
-			paused			  = !paused;
-			win_paused_active = false;
-		}
-		else if (g_key == CH_SHAPE_SHADOW_L || g_key == CH_SHAPE_SHADOW_U)
-		{
-			shape_shadow_enabled = !shape_shadow_enabled;
-		}
+		publish_frame();
 	}
 }
 
-static void update_current_shape(void)
+// no frames while paused, otherwise the next one is due when the shape falls
+// a row unless something is being animated
+float32_t screen_stage_next_wakeup(void)
 {
-	current_shape_elapsed_time += g_delta_time;
-
-	current_shape.prev_pos.x = current_shape.pos.x;
-	current_shape.prev_pos.y = current_shape.pos.y;
-
-	if (player_action == PLAYER_ACTION_MOVE_LEFT)
-	{
-		current_shape.pos.x -= 1;
-	}
-	else if (player_action == PLAYER_ACTION_MOVE_RIGHT)
-	{
-		current_shape.pos.x += 1;
-	}
-	else if (player_action == PLAYER_ACTION_ROTATE)
-	{
-		rotate_shape(false);
-	}
-	else if (player_action == PLAYER_ACTION_SPEEDUP)
+	if (paused)
 	{
-		velocity = c_speedup_velocity;
+		return win_paused_active ? SCREEN_WAKEUP_IDLE : 0;
 	}
 
-	if (player_action == PLAYER_ACTION_HARD_DROP)
-	{
-		drop_shape();
-	}
-	else if (current_shape_elapsed_time >= (c_shape_base_velocity - (velocity * 0.1)))
+	if (bot_enabled ||
+		engine_is_game_over(&engine) ||
+		engine_is_animating(&engine) ||
+		g_score.current_label != g_score.current ||
+		g_score.record_label != g_score.record)
 	{
-		current_shape_elapsed_time = 0;
-		current_shape.pos.y += 1;
+		return 0;
 	}
 
-	if (shape_shadow_enabled)
-	{
-		current_shape.shadow_pos_y = get_shape_dest_pos_y();
-	}
+	return engine_get_drop_time_left(&engine);
 }
 
-static void rotate_shape(bool backward)
+void screen_stage_window_resized(void)
 {
-	uint8_t shape_size = c_shape_size[current_shape.type];
-	bool	shape_aux[SHAPE_MAX_SIZE * SHAPE_MAX_SIZE];
-	bool	val;
+	render_windows();
+	render_win_next_shape();
+	render_win_score();
+	render_win_board();
 
-	for (uint8_t y = 0; y < shape_size; y++)
+	if (paused)
 	{
-		for (uint8_t x = 0; x < shape_size; x++)
-		{
-			if (backward)
-			{
-				val = current_shape.val[shape_size * y + x];
-
-				shape_aux[(shape_size * (shape_size - x - 1)) + y] = val;
-			}
-			else
-			{
-				val = current_shape.val[(shape_size * (shape_size - x - 1)) + y];
-
-				shape_aux[shape_size * y + x] = val;
-			}
-		}
+		render_win_paused();
 	}
 
-	memcpy(current_shape.val, shape_aux, shape_size * shape_size);
-	set_shape_padding(&current_shape);
+#ifdef PROFILE
+	profile_elapsed_time = c_win_profile_interval;
+#endif
 }
 
-static void set_shape_padding(shape_t *shape)
+// INIT
+// the board window is as large as the board, or as much of it as fits on the
+// terminal next to the other windows
+static void create_windows(void)
 {
-	int8_t	padding_left   = -1;
-	int8_t	padding_right  = -1;
-	int8_t	padding_top	   = -1;
-	int8_t	padding_bottom = -1;
-	uint8_t shape_size	   = c_shape_size[shape->type];
-
-	for (uint8_t y = 0; y < shape_size; y++)
-	{
-		for (uint8_t x = 0; x < shape_size; x++)
-		{
-			// left
-			bool filled = shape->val[shape_size * y + x];
+	uint16_t offset_y, offset_x;
+	uint16_t rows, cols;
 
-			if ((padding_left == -1 || x < padding_left) && filled)
-			{
-				padding_left = x;
-			}
+	render_get_size(&rows, &cols);
 
-			// right
-			filled = shape->val[shape_size * y + (shape_size - x - 1)];
+	// board cells are two columns wide
+	uint16_t board_rows		  = get_fit_size(g_board_size.rows, rows, c_win_pause_hint_height + (c_win_padding * 2));
+	uint16_t board_cols		  = get_fit_size(g_board_size.cols, cols / 2, (c_win_next_shape_width / 2) + c_win_padding);
+	uint16_t win_board_height = board_rows + (c_win_padding * 2);
+	uint16_t win_board_width  = (board_cols * 2) + (c_win_padding * 2);
+	uint16_t win_height		  = win_board_height > c_win_next_shape_height + c_win_score_height ? win_board_height : c_win_next_shape_height + c_win_score_height;
 
-			if ((padding_right == -1 || x < padding_right) && filled)
-			{
-				padding_right = x;
-			}
+	set_offset_yx(win_height + c_win_pause_hint_height, win_board_width + c_win_next_shape_width, &offset_y, &offset_x);
+	win_board = render_window_new(win_board_height, win_board_width, offset_y, offset_x);
 
-			// top
-			filled = shape->val[shape_size * x + y];
+	win_next_shape = render_window_new(c_win_next_shape_height, c_win_next_shape_width, offset_y, offset_x + win_board_width);
 
-			if ((padding_top == -1 || x < padding_top) && filled)
-			{
-				padding_top = x;
-			}
+	win_score = render_window_new(c_win_score_height, c_win_score_width, offset_y + c_win_next_shape_height, offset_x + win_board_width);
 
-			// bottom
-			filled = shape->val[(shape_size * (shape_size - x - 1)) + y];
+	win_pause_hint = render_window_new(c_win_pause_hint_height, win_board_width + c_win_next_shape_width, offset_y + win_height, offset_x);
 
-			if ((padding_bottom == -1 || x < padding_bottom) && filled)
-			{
-				padding_bottom = x;
-			}
-		}
-	}
+	set_offset_yx(c_win_paused_height, c_win_paused_width, &offset_y, &offset_x);
+	win_paused = render_window_new(c_win_paused_height, c_win_paused_width, offset_y, offset_x);
 
-	shape->padding_left	  = padding_left;
-	shape->padding_right  = padding_right;
-	shape->padding_top	  = padding_top;
-	shape->padding_bottom = padding_bottom;
-	shape->width		  = shape_size - padding_left - padding_right;
-	shape->height		  = shape_size - padding_top - padding_bottom;
-}
+#ifdef PROFILE
+	// top left corner, above the board on the default terminal size
+	win_profile = render_window_new(c_win_profile_height, c_win_profile_width, 0, 0);
+#endif
 
-static void drop_shape(void)
-{
-	current_shape.pos.y = get_shape_dest_pos_y();
-	set_shape_on_board();
-	scan_board_filled_rows();
-	set_prev_shape();
-	set_current_shape();
-	set_next_shape();
+	board_cells		 = cell_buffer_new(&g_screens_arena, &win_board, board_rows, board_cols * 2, c_win_padding, c_win_padding);
+	next_shape_cells = cell_buffer_new(&g_screens_arena, &win_next_shape, c_win_next_shape_height - 3, c_win_next_shape_width - 2, c_win_padding, c_win_padding);
 }
 
-static uint8_t get_shape_dest_pos_y(void)
+// UPDATE
+static void handle_input(void)
 {
-	uint8_t board_floor	 = BOARD_ROWS;
-	uint8_t shape_left_x = current_shape.pos.x + current_shape.padding_left;
-	uint8_t shape_size	 = c_shape_size[current_shape.type];
-	bool	collided	 = false;
-	uint8_t result;
+	player_actions_count = 0;
 
-	for (int16_t y = current_shape.pos.y; y <= board_floor && !collided; y++)
+	for (uint8_t i = 0; i < input_get_keys_count(); i++)
 	{
-		for (uint8_t y_shape = 0; y_shape < current_shape.height && !collided; y_shape++)
+		int				key	   = input_get_key(i);
+		player_action_t action = PLAYER_ACTION_IDLE;
+
+		if (key == CH_LEFT)
 		{
-			for (uint8_t x_shape = 0; x_shape < current_shape.width && !collided; x_shape++)
-			{
-				bool shape_filled = current_shape.val[shape_size * (y_shape + current_shape.padding_top) + (x_shape + current_shape.padding_left)];
-				bool board_filled = board[BOARD_COLS * (y + y_shape + current_shape.padding_top) + (shape_left_x + x_shape)] > 0;
-				collided		  = (shape_filled && board_filled) || (y + current_shape.padding_top + current_shape.height) > board_floor;
-
-				if (collided)
-				{
-					result = y - 1;
-				}
-			}
+			action = PLAYER_ACTION_MOVE_LEFT;
 		}
-	}
-
-	return result;
-}
-
-static void handle_collision(void)
-{
-	// side board collision
-	if ((current_shape.pos.x + current_shape.padding_left) < 0)
-	{
-		current_shape.pos.x++;
-	}
-	else if ((current_shape.pos.x + current_shape.padding_left + current_shape.width) > BOARD_COLS)
-	{
-		current_shape.pos.x = BOARD_COLS - current_shape.width - current_shape.padding_left;
-	}
-
-	// bottom board collision
-	uint8_t shape_bottom_y = current_shape.pos.y + current_shape.padding_top + current_shape.height;
-	bool	y_collided	   = shape_bottom_y > BOARD_ROWS;
-	uint8_t shape_size	   = c_shape_size[current_shape.type];
-
-	// board blocks collision
-	if (!y_collided && shape_bottom_y > board_top_row_filled)
-	{
-		for (uint8_t y = 0; y < current_shape.height && !y_collided; y++)
+		else if (key == CH_RIGHT)
 		{
-			for (uint8_t x = 0; x < current_shape.width && !y_collided; x++)
-			{
-				bool	 filled = current_shape.val[shape_size * (y + current_shape.padding_top) + (x + current_shape.padding_left)];
-				uint16_t index =
-					(BOARD_COLS *
-						 (uint16_t)(current_shape.pos.y + current_shape.padding_top + y) +
-					 (uint16_t)(current_shape.pos.x + current_shape.padding_left + x));
-
-				y_collided = filled && board[index] > 0;
-			}
+			action = PLAYER_ACTION_MOVE_RIGHT;
 		}
-	}
-
-	if (y_collided)
-	{
-		if (player_action == PLAYER_ACTION_ROTATE)
+		else if (key == CH_UP)
 		{
-			rotate_shape(true);
+			action = PLAYER_ACTION_ROTATE;
 		}
-		else
+		else if (key == CH_DOWN)
 		{
-			current_shape.pos.x = current_shape.prev_pos.x;
-			current_shape.pos.y = current_shape.prev_pos.y;
+			action = PLAYER_ACTION_SPEEDUP;
 		}
-
-		if (player_action != PLAYER_ACTION_MOVE_LEFT && player_action != PLAYER_ACTION_MOVE_RIGHT && player_action != PLAYER_ACTION_ROTATE)
+		else if (key == CH_SPACE)
 		{
-			set_shape_on_board();
-			scan_board_filled_rows();
-			set_prev_shape();
-			set_current_shape();
-			set_next_shape();
+			action = PLAYER_ACTION_HARD_DROP;
 		}
-	}
-}
-
-static void set_shape_on_board(void)
-{
-	uint8_t color	   = c_shape_colors[current_shape.type];
-	uint8_t shape_size = c_shape_size[current_shape.type];
-	uint8_t height	   = current_shape.pos.y;
-
-	if (height < board_top_row_filled)
-	{
-		board_top_row_filled = height;
-	}
-
-	for (uint8_t y = 0; y < current_shape.height; y++)
-	{
-		for (uint8_t x = 0; x < current_shape.width; x++)
+		else if (key == CH_PAUSE_L || key == CH_PAUSE_U)
 		{
-			bool filled = current_shape.val[shape_size * (y + current_shape.padding_top) + (x + current_shape.padding_left)];
+			paused				 = !paused;
+			win_paused_active	 = false;
+			player_actions_count = 0;
 
-			if (filled)
+			if (!paused)
 			{
-				uint16_t index =
-					BOARD_COLS *
-						(uint16_t)(current_shape.pos.y + current_shape.padding_top + y) +
-					(uint16_t)(current_shape.pos.x + current_shape.padding_left + x);
-
-				board[index] = color;
+				render_windows();
 			}
 		}
-	}
-}
-
-static void scan_board_filled_rows(void)
-{
-	uint8_t cells_filled_length;
-	filled_rows_elapsed_time = 0;
-
-	for (int16_t y = BOARD_ROWS - 1; y >= board_top_row_filled; y--)
-	{
-		cells_filled_length = 0;
-
-		for (uint8_t x = 0; x < BOARD_COLS; x++)
+		else if (key == CH_SHAPE_SHADOW_L || key == CH_SHAPE_SHADOW_U)
 		{
-			cells_filled_length += board[BOARD_COLS * y + x] ? 1 : 0;
+			engine.shape_shadow_enabled = !engine.shape_shadow_enabled;
 		}
-
-		if (cells_filled_length == BOARD_COLS)
+		else if (key == CH_BOT_L || key == CH_BOT_U)
 		{
-			sparse_set_add(&filled_rows_indexes, (uint8_t)y);
+			bot_enabled = !bot_enabled;
 		}
-	}
-}
-
-static void process_board_filled_rows(void)
-{
-	uint8_t filled_rows_length = VECTOR_LENGTH(filled_rows_indexes.dense);
-	uint8_t rows_to_move	   = 0;
-	uint8_t rows_to_remove	   = 0;
-	size_t	size			   = 0;
-
-	if (filled_rows_length == 0)
-	{
-		return;
-	}
-
-	filled_rows_elapsed_time += g_delta_time;
-
-	if (filled_rows_elapsed_time < c_filled_rows_animation_lifetime)
-	{
-		return;
-	}
-
-	for (int16_t y = BOARD_ROWS - 1; y >= board_top_row_filled; y--)
-	{
-		bool row_to_remove = SPARSE_SET_CONTAINS(filled_rows_indexes, y);
-
-		if (!row_to_remove && rows_to_remove > 0)
+#ifdef PROFILE
+		else if (key == CH_PROFILE_L || key == CH_PROFILE_U)
 		{
-			rows_to_move++;
-		}
+			profile_visible		 = !profile_visible;
+			profile_elapsed_time = c_win_profile_interval;
 
-		if (row_to_remove || y == board_top_row_filled)
-		{
-			if (rows_to_move > 0)
+			if (!profile_visible)
 			{
-				size			= sizeof(uint8_t) * rows_to_move * BOARD_COLS;
-				uint8_t *dest	= (board + ((y + rows_to_remove) * BOARD_COLS));
-				uint8_t *source = (board + (y * BOARD_COLS));
-				memmove(dest, source, size);
-
-				rows_to_move = 0;
+				render_erase(&win_profile);
+				compositor_submit(&win_profile);
 			}
+		}
+#endif
 
-			rows_to_remove++;
+		if (action != PLAYER_ACTION_IDLE && !paused)
+		{
+			player_actions[player_actions_count++] = action;
 		}
 	}
 
-	sparse_set_clear(&filled_rows_indexes);
-
-	size = sizeof(uint8_t) * filled_rows_length * BOARD_COLS;
-	memset(board + (board_top_row_filled * BOARD_COLS), 0, size);
-	board_top_row_filled += filled_rows_length;
-
-	g_score.current += filled_rows_length;
-
-	if (g_score.current > g_score.record)
+	// the bot plays one action per frame, so it can be followed
+	if (bot_enabled && !paused && player_actions_count < INPUT_KEYS_CAPACITY)
 	{
-		g_score.record += filled_rows_length;
-	}
+		player_action_t action = bot_next_action(&bot, &engine);
 
-	if (level < c_max_level)
-	{
-		level = (uint8_t)ceil((float32_t)g_score.current / 10);
+		if (action != PLAYER_ACTION_IDLE)
+		{
+			player_actions[player_actions_count++] = action;
+		}
 	}
 }
 
@@ -622,80 +417,52 @@ static void process_game_over_filled_rows(void)
 	}
 }
 
-static void process_prev_shape_animation(void)
+static void update_score(void)
 {
-	if (prev_shape.width == 0)
-	{
-		return;
-	}
+	g_score.current = engine.score;
 
-	prev_shape_elapsed_time += g_delta_time;
-
-	if (prev_shape_elapsed_time >= c_prev_shape_animation_lifetime)
+	if (g_score.current > g_score.record)
 	{
-		prev_shape.width  = 0;
-		prev_shape.height = 0;
+		g_score.record = g_score.current;
 	}
 }
 
-static void set_next_shape(void)
+// every game goes to the leaderboard, but those quit before scoring
+static void save_score(void)
 {
-	next_shape.type = rand() % SHAPES_COUNT;
-	uint8_t size	= c_shape_size[next_shape.type];
-
-	memset(next_shape.val, 0, sizeof(uint8_t) * (SHAPE_MAX_SIZE * SHAPE_MAX_SIZE));
-	memcpy(next_shape.val, c_shape_list[next_shape.type], size * size);
-	set_shape_padding(&next_shape);
+	leaderboard_entry_t entry = {
+		.score		 = engine.score,
+		.lines		 = engine.lines,
+		.duration_ms = game_time_ms,
+		.seed		 = seed,
+	};
 
-	next_shape.pos.x = (BOARD_COLS - (c_win_padding * 2)) * 0.5 - next_shape.width * 0.5 + next_shape.padding_left;
-	next_shape.pos.y = c_win_next_shape_height * 0.5 - next_shape.height * 0.5 - next_shape.padding_top - c_win_padding;
-}
+	if (g_score.current > g_score.record)
+	{
+		g_score.record = g_score.current;
+	}
 
-static void set_prev_shape(void)
-{
-	uint8_t size = c_shape_size[current_shape.type];
-
-	prev_shape.type			  = current_shape.type;
-	prev_shape.pos			  = current_shape.pos;
-	prev_shape.width		  = current_shape.width;
-	prev_shape.height		  = current_shape.height;
-	prev_shape.padding_left	  = current_shape.padding_left;
-	prev_shape.padding_right  = current_shape.padding_right;
-	prev_shape.padding_top	  = current_shape.padding_top;
-	prev_shape.padding_bottom = current_shape.padding_bottom;
-
-	memset(prev_shape.val, 0, sizeof(uint8_t) * (SHAPE_MAX_SIZE * SHAPE_MAX_SIZE));
-	memcpy(prev_shape.val, current_shape.val, size * size);
-	prev_shape_elapsed_time = 0;
+	if (engine.score > 0 || engine_is_game_over(&engine))
+	{
+		score_store_save(&entry);
+	}
 }
 
-static void set_current_shape(void)
+// delta time is rounded to what the replay holds, so the replayed game
+// steps exactly like this one
+static void step_engine(player_action_t action, float32_t delta_time)
 {
-	uint8_t size = c_shape_size[next_shape.type];
-
-	current_shape.type = next_shape.type;
-	memset(current_shape.val, 0, sizeof(uint8_t) * (SHAPE_MAX_SIZE * SHAPE_MAX_SIZE));
-	memcpy(current_shape.val, c_shape_list[current_shape.type], size * size);
-	set_shape_padding(&current_shape);
+	uint32_t delta_time_ms = replay_get_delta_time_ms(delta_time + delta_time_remainder);
 
-	current_shape.pos.x = floor(BOARD_COLS * 0.5 - current_shape.width * 0.5 + current_shape.padding_left);
-	current_shape.pos.y = 0;
-}
+	delta_time_remainder += delta_time - replay_get_delta_time(delta_time_ms);
+	game_time_ms += delta_time_ms;
 
-static void save_score(void)
-{
-	if (g_score.current < g_score.record)
+	if (g_record_file)
 	{
-		return;
+		replay_record_step(&replay, action, delta_time_ms);
 	}
 
-	g_score.record = g_score.current;
-
-	FILE *f = fopen(FILE_SCORE, "w");
-	ASSERT(f);
-
-	fprintf(f, "%d", g_score.record);
-	fclose(f);
+	engine_step(&engine, action, replay_get_delta_time(delta_time_ms));
 }
 
 static void update_score_labels(void)
@@ -722,77 +489,97 @@ static void update_score_labels(void)
 }
 
 // RENDER
-static void render_win_board(void)
+static void render_windows(void)
 {
-	wattron(win_board, COLOR_PAIR(COLOR_PAIR_MAGENTA_MEDIUM));
-	box(win_board, 0, 0);
-	wattroff(win_board, COLOR_PAIR(COLOR_PAIR_MAGENTA_MEDIUM));
+	const char *next_shape_title	= "NEXT";
+	const char *level_label			= "Level:";
+	const char *score_title			= "SCORE";
+	const char *current_score_label = "Current:";
+	const char *max_score_label		= "Top:";
+	const char *pause_hint_label	= "*press (p) to open pause/options menu";
+	uint8_t		padding_x			= c_win_padding * 2;
+
+	// board
+	render_box(&win_board, COLOR_PAIR(COLOR_PAIR_MAGENTA_MEDIUM));
+
+	// next shape
+	render_box(&win_next_shape, COLOR_PAIR(COLOR_PAIR_MAGENTA_MEDIUM));
+	render_text(&win_next_shape, 0, (c_win_next_shape_width * 0.5) - floor(strlen(next_shape_title) * 0.5), COLOR_PAIR(COLOR_PAIR_MAGENTA_HIGH), "%s", next_shape_title);
+	render_text(&win_next_shape, c_win_next_shape_height - 2, padding_x, COLOR_PAIR(COLOR_PAIR_GREEN_DEFAULT), "%s", level_label);
+
+	// score
+	render_box(&win_score, COLOR_PAIR(COLOR_PAIR_MAGENTA_MEDIUM));
+	render_text(&win_score, 0, (c_win_score_width * 0.5) - floor(strlen(score_title) * 0.5), COLOR_PAIR(COLOR_PAIR_MAGENTA_HIGH), "%s", score_title);
+	render_text(&win_score, c_win_padding * 2, padding_x, 0, "%s", current_score_label);
+	render_text(&win_score, (c_win_padding * 2) + 1, padding_x, COLOR_PAIR(COLOR_PAIR_GREEN_DEFAULT), "%s", max_score_label);
+
+	// pause hint
+	render_erase(&win_pause_hint);
+	render_text(&win_pause_hint, 0, 0, 0, "%s", pause_hint_label);
+	compositor_submit(&win_pause_hint);
+
+	// whatever was on screen over these windows (e.g. the paused window) is
+	// unknown, so everything is sent again on next refresh
+	render_touch(&win_board);
+	render_touch(&win_next_shape);
+	render_touch(&win_score);
+
+	hud.valid = false;
 }
 
-static void render_win_next_shape()
+static void render_win_board(void)
 {
-	werase(win_next_shape);
-	char		level_count[3] = { '\0' };
-	const char *title		   = "NEXT";
-	const char *lines_label	   = "Level:";
+	stage_draw_follow_shape(&board_cells, &engine, &board_view);
+	cell_buffer_clear(&board_cells);
+	stage_draw_board(&board_cells, &engine, board_view, game_over_filled_rows);
+	PROFILE_COUNT(PROFILE_COUNTER_CELLS, cell_buffer_flush(&board_cells));
+
+	compositor_submit(&win_board);
+}
 
+static void render_win_next_shape(void)
+{
 	uint8_t padding_x = c_win_padding * 2,
 			padding_y = c_win_next_shape_height - 2;
 
-	sprintf(level_count, "%d", level);
+	if (hud.valid && hud.level == engine.level && hud.next_shape_type == engine.next_shape.type)
+	{
+		return;
+	}
 
-	wattron(win_next_shape, COLOR_PAIR(COLOR_PAIR_MAGENTA_MEDIUM));
-	box(win_next_shape, 0, 0);
-	wattroff(win_next_shape, COLOR_PAIR(COLOR_PAIR_MAGENTA_MEDIUM));
+	hud.level			= engine.level;
+	hud.next_shape_type = engine.next_shape.type;
 
-	// title
-	wattron(win_next_shape, COLOR_PAIR(COLOR_PAIR_MAGENTA_HIGH));
-	mvwprintw(win_next_shape, 0, (c_win_next_shape_width * 0.5) - floor(strlen(title) * 0.5), "%s", title);
-	wattroff(win_next_shape, COLOR_PAIR(COLOR_PAIR_MAGENTA_HIGH));
 	// level
-	wattron(win_next_shape, COLOR_PAIR(COLOR_PAIR_GREEN_DEFAULT));
-	mvwprintw(win_next_shape, padding_y, padding_x, "%s", lines_label);
-	mvwprintw(win_next_shape, padding_y, strlen(lines_label) + padding_x + 1, "%s", level_count);
-	wattroff(win_next_shape, COLOR_PAIR(COLOR_PAIR_GREEN_DEFAULT));
-	// shape
-	render_shape(win_next_shape, &next_shape, false);
-
-	wrefresh(win_next_shape);
+	render_text(&win_next_shape, padding_y, strlen("Level:") + padding_x + 1, COLOR_PAIR(COLOR_PAIR_GREEN_DEFAULT), "%-3d", engine.level);
+	// shape, centered on the window
+	cell_buffer_clear(&next_shape_cells);
+	stage_draw_next_shape(&next_shape_cells, &engine.next_shape, c_win_next_shape_height, c_win_next_shape_width);
+	PROFILE_COUNT(PROFILE_COUNTER_CELLS, cell_buffer_flush(&next_shape_cells));
+
+	compositor_submit(&win_next_shape);
 }
 
-static void render_win_score()
+static void render_win_score(void)
 {
-	werase(win_score);
-	char		max_score[10]		= { '\0' };
-	char		current_score[10]	= { '\0' };
-	const char *title				= "SCORE";
-	const char *current_score_label = "Current:";
-	const char *max_score_label		= "Top:";
-
-	uint8_t padding_x = c_win_padding * 2,
+	uint8_t padding_x = strlen("Current:") + (c_win_padding * 2) + 1,
 			padding_y = c_win_padding * 2;
 
-	sprintf(current_score, "%d", (uint16_t)(g_score.current_label));
-	sprintf(max_score, "%d", (uint16_t)(g_score.record_label));
+	if (hud.valid && hud.current_label == g_score.current_label && hud.record_label == g_score.record_label)
+	{
+		return;
+	}
 
-	wattron(win_score, COLOR_PAIR(COLOR_PAIR_MAGENTA_MEDIUM));
-	box(win_score, 0, 0);
-	wattroff(win_score, COLOR_PAIR(COLOR_PAIR_MAGENTA_MEDIUM));
+	hud.current_label = g_score.current_label;
+	hud.record_label  = g_score.record_label;
+	hud.valid		  = true;
 
-	// title
-	wattron(win_score, COLOR_PAIR(COLOR_PAIR_MAGENTA_HIGH));
-	mvwprintw(win_score, 0, (c_win_score_width * 0.5) - floor(strlen(title) * 0.5), "%s", title);
-	wattroff(win_score, COLOR_PAIR(COLOR_PAIR_MAGENTA_HIGH));
 	// current score
-	mvwprintw(win_score, padding_y, padding_x, "%s", current_score_label);
-	mvwprintw(win_score, padding_y, strlen(current_score_label) + padding_x + 1, "%s", current_score);
+	render_text(&win_score, padding_y, padding_x, 0, "%-5d", (uint16_t)(g_score.current_label));
 	// max score
-	wattron(win_score, COLOR_PAIR(COLOR_PAIR_GREEN_DEFAULT));
-	mvwprintw(win_score, padding_y + 1, padding_x, "%s", max_score_label);
-	mvwprintw(win_score, padding_y + 1, strlen(current_score_label) + padding_x + 1, "%s", max_score);
-	wattroff(win_score, COLOR_PAIR(COLOR_PAIR_GREEN_DEFAULT));
+	render_text(&win_score, padding_y + 1, padding_x, COLOR_PAIR(COLOR_PAIR_GREEN_DEFAULT), "%-5d", (uint16_t)(g_score.record_label));
 
-	wrefresh(win_score);
+	compositor_submit(&win_score);
 }
 
 static void render_win_paused(void)
@@ -806,125 +593,93 @@ static void render_win_paused(void)
 	const char *key_label_speedup	  = "speed up     : arrow down";
 	const char *key_label_hard_drop	  = "hard drop    : space";
 	const char *key_label_shadow_mode = "shape shadow : s";
+	const char *key_label_bot		  = "autoplay     : b";
 
-	werase(win_paused);
-	wattron(win_paused, COLOR_PAIR(COLOR_PAIR_MAGENTA_MEDIUM));
-	box(win_paused, 0, 0);
-	wattroff(win_paused, COLOR_PAIR(COLOR_PAIR_MAGENTA_MEDIUM));
+	render_erase(&win_paused);
+	render_box(&win_paused, COLOR_PAIR(COLOR_PAIR_MAGENTA_MEDIUM));
 
 	// title
-	wattron(win_paused, COLOR_PAIR(COLOR_PAIR_MAGENTA_HIGH));
-	mvwprintw(win_paused, 0, (c_win_paused_width * 0.5) - floor(strlen(title) * 0.5), "%s", title);
-	wattroff(win_paused, COLOR_PAIR(COLOR_PAIR_MAGENTA_HIGH));
+	render_text(&win_paused, 0, (c_win_paused_width * 0.5) - floor(strlen(title) * 0.5), COLOR_PAIR(COLOR_PAIR_MAGENTA_HIGH), "%s", title);
 	// key controls
-	mvwprintw(win_paused, y++, padding_x, "%s", key_label_left);
-	mvwprintw(win_paused, y++, padding_x, "%s", key_label_right);
-	mvwprintw(win_paused, y++, padding_x, "%s", key_label_rotate);
-	mvwprintw(win_paused, y++, padding_x, "%s", key_label_speedup);
-	mvwprintw(win_paused, y++, padding_x, "%s", key_label_hard_drop);
-	mvwprintw(win_paused, y++, padding_x, "%s", key_label_shadow_mode);
-
-	wrefresh(win_paused);
+	render_text(&win_paused, y++, padding_x, 0, "%s", key_label_left);
+	render_text(&win_paused, y++, padding_x, 0, "%s", key_label_right);
+	render_text(&win_paused, y++, padding_x, 0, "%s", key_label_rotate);
+	render_text(&win_paused, y++, padding_x, 0, "%s", key_label_speedup);
+	render_text(&win_paused, y++, padding_x, 0, "%s", key_label_hard_drop);
+	render_text(&win_paused, y++, padding_x, 0, "%s", key_label_shadow_mode);
+	render_text(&win_paused, y++, padding_x, 0, "%s", key_label_bot);
+
+	compositor_submit(&win_paused);
 	win_paused_active = true;
 }
 
-static void render_win_pause_hint(void)
-{
-	const char *label = "*press (p) to open pause/options menu";
-
-	wclear(win_pause_hint);
-	mvwprintw(win_pause_hint, 0, 0, "%s", label);
-	wrefresh(win_pause_hint);
+// the board and next shape as drawn (the last frame's while paused), for
+// spectators. Only what changed goes out
+static void publish_frame(void)
+{
+	broadcast_frame_t frame = {
+		.panels = {
+			[BROADCAST_PANEL_BOARD]		 = { board_cells.cells, board_cells.rows, board_cells.cols },
+			[BROADCAST_PANEL_NEXT_SHAPE] = { next_shape_cells.cells, next_shape_cells.rows, next_shape_cells.cols },
+		},
+		.hud = {
+			.score	   = g_score.current,
+			.record	   = g_score.record,
+			.level	   = engine.level,
+			.game_over = engine_is_game_over(&engine),
+			.paused	   = paused,
+		},
+	};
+
+	broadcast_publish(&frame);
 }
 
-static void render_shape(WINDOW *win, shape_t *shape, bool shadow)
+#ifdef PROFILE
+// rolling stats of the last PROFILE_FRAMES frames, times in milliseconds
+static void render_win_profile(void)
 {
-	uint8_t color	   = c_shape_colors[shape->type];
-	uint8_t shape_size = c_shape_size[shape->type];
+	profile_stats_t stats;
+	uint8_t			y		  = 1;
+	const char	   *title	  = "FRAME TIMING (ms)";
+	const char	   *row_label = "%-10s %7.3f %7.3f %7.3f %7.3f";
 
-	for (uint8_t y = 0; y < shape_size; y++)
+	if (!profile_visible)
 	{
-		for (uint8_t x = 0; x < shape_size; x++)
-		{
-			bool filled = shape->val[shape_size * y + x];
+		return;
+	}
 
-			if (filled && shadow)
-			{
-				wattron(win, COLOR_PAIR(color * 10));
-				mvwprintw(win, shape->shadow_pos_y + y + c_win_padding, (shape->pos.x * 2) + (x * 2) + c_win_padding, "[]");
-				wattroff(win, COLOR_PAIR(color * 10));
-			}
+	profile_elapsed_time += g_delta_time;
 
-			if (filled)
-			{
-				wattron(win, COLOR_PAIR(color));
-				mvwprintw(win, shape->pos.y + y + c_win_padding, (shape->pos.x * 2) + (x * 2) + c_win_padding, "[]");
-				wattroff(win, COLOR_PAIR(color));
-			}
-		}
+	if (profile_elapsed_time < c_win_profile_interval)
+	{
+		return;
 	}
-}
 
-static void render_board(void)
-{
-	uint8_t color			= 0;
-	uint8_t prev_shape_size = c_shape_size[prev_shape.type];
+	profile_elapsed_time = 0;
 
-	for (int16_t y = BOARD_ROWS - 1; y >= board_top_row_filled; y--)
+	render_erase(&win_profile);
+	render_box(&win_profile, COLOR_PAIR(COLOR_PAIR_MAGENTA_MEDIUM));
+	render_text(&win_profile, 0, (c_win_profile_width * 0.5) - floor(strlen(title) * 0.5), COLOR_PAIR(COLOR_PAIR_MAGENTA_HIGH), "%s", title);
+
+	render_text(&win_profile, y++, 2, COLOR_PAIR(COLOR_PAIR_GREEN_DEFAULT), "%-10s %7s %7s %7s %7s", "phase", "min", "mean", "p99", "max");
+
+	for (uint8_t i = 0; i < PROFILE_PHASE_COUNT; i++)
 	{
-		for (uint8_t x = 0; x < BOARD_COLS; x++)
-		{
-			// white rows for game over animation
-			if (board_top_row_filled == 0 && game_over_filled_rows >= (BOARD_ROWS - y))
-			{
-				wattron(win_board, COLOR_PAIR(COLOR_PAIR_WHITE_HIGH));
-				mvwaddch(win_board, y + c_win_padding, (x * 2) + c_win_padding, CH_SHAPE_FILL);
-				mvwaddch(win_board, y + c_win_padding, (x * 2) + 1 + c_win_padding, CH_SHAPE_FILL);
-				wattroff(win_board, COLOR_PAIR(COLOR_PAIR_WHITE_HIGH));
-			}
-			else
-			{
-				color = board[BOARD_COLS * y + x];
-
-				if (!color)
-				{
-					continue;
-				}
-
-				bool filled_row = SPARSE_SET_CONTAINS(filled_rows_indexes, y);
-
-				// white highlight for filled (completed) rows
-				if (filled_row)
-				{
-					color = COLOR_PAIR_WHITE_HIGH - ((uint8_t)((filled_rows_elapsed_time) * 10) % 3);
-					wattron(win_board, COLOR_PAIR(color));
-					mvwaddch(win_board, y + c_win_padding, (x * 2) + c_win_padding, CH_SHAPE_FILL);
-					mvwaddch(win_board, y + c_win_padding, (x * 2) + 1 + c_win_padding, CH_SHAPE_FILL);
-					wattroff(win_board, COLOR_PAIR(color));
-				}
-				// highlight animation for last shape
-				else if (prev_shape.width > 0 &&
-						 (x >= (prev_shape.pos.x + prev_shape.padding_left)) &&
-						 (x < (prev_shape.pos.x + prev_shape.padding_left + prev_shape.width)) &&
-						 (y >= (prev_shape.pos.y + prev_shape.padding_top)) &&
-						 (y < (prev_shape.pos.y + prev_shape.padding_top + prev_shape.height)) &&
-						 prev_shape.val[prev_shape_size * (uint8_t)(y - prev_shape.pos.y) + (uint8_t)(x - prev_shape.pos.x)])
-				{
-					color = (color * 10) + ((uint8_t)((prev_shape_elapsed_time) * 10) % 3);
-					wattron(win_board, COLOR_PAIR(color));
-					mvwaddch(win_board, y + c_win_padding, (x * 2) + c_win_padding, CH_SHAPE_FILL);
-					mvwaddch(win_board, y + c_win_padding, (x * 2) + 1 + c_win_padding, CH_SHAPE_FILL);
-					wattroff(win_board, COLOR_PAIR(color));
-				}
-				// defaul blocks color
-				else
-				{
-					wattron(win_board, COLOR_PAIR(color));
-					mvwaddch(win_board, y + c_win_padding, (x * 2) + c_win_padding, '[');
-					mvwaddch(win_board, y + c_win_padding, (x * 2) + 1 + c_win_padding, ']');
-					wattroff(win_board, COLOR_PAIR(color));
-				}
-			}
-		}
+		profile_get_phase_stats(i, &stats);
+		render_text(&win_profile, y++, 2, 0, row_label, profile_get_phase_name(i), stats.min, stats.mean, stats.p99, stats.max);
 	}
-}
\ No newline at end of file
+
+	profile_get_busy_stats(&stats);
+	render_text(&win_profile, y++, 2, 0, row_label, "busy", stats.min, stats.mean, stats.p99, stats.max);
+
+	render_text(&win_profile, y++, 2, COLOR_PAIR(COLOR_PAIR_GREEN_DEFAULT), "%-10s %7s %7s %7s %7s", "per frame", "min", "mean", "p99", "max");
+
+	for (uint8_t i = 0; i < PROFILE_COUNTER_COUNT; i++)
+	{
+		profile_get_counter_stats(i, &stats);
+		render_text(&win_profile, y++, 2, 0, "%-10s %7.0f %7.1f %7.0f %7.0f", profile_get_counter_name(i), stats.min, stats.mean, stats.p99, stats.max);
+	}
+
+	compositor_submit(&win_profile);
+}
+#endif
\ No newline at end of file
@@ -3,11 +3,14 @@
 
 #include "../defs.h"
 
-void screen_stage_init(void);
-void screen_stage_dispose(void);
-bool screen_stage_is_completed(void);
-void screen_stage_update(void);
-void screen_stage_render(void);
-void screen_stage_window_resized(void);
+void		screen_stage_create(void);
+void		screen_stage_destroy(void);
+void		screen_stage_init(void);
+void		screen_stage_dispose(void);
+bool		screen_stage_is_completed(void);
+void		screen_stage_update(void);
+void		screen_stage_render(void);
+float32_t	screen_stage_next_wakeup(void);
+void		screen_stage_window_resized(void);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,20 @@
+#include "screen_utils.h"
+
+// centered, or on the top left when it's larger than the terminal
+void set_offset_yx(uint16_t height, uint16_t width, uint16_t *offset_y, uint16_t *offset_x)
+{
+	uint16_t rows, cols;
+	render_get_size(&rows, &cols);
+
+	*offset_y = rows > height ? (rows - height) / 2 : 0;
+	*offset_x = cols > width ? (cols - width) / 2 : 0;
+}
+
+// size, or as much of it as fits in what's left of available once taken is
+// used (at least 1, however small the terminal)
+uint16_t get_fit_size(uint16_t size, uint16_t available, uint16_t taken)
+{
+	uint16_t left = available > taken ? available - taken : 1;
+
+	return size < left ? size : left;
+}
@@ -0,0 +1,12 @@
+#ifndef SCREEN_UTILS_H
+#define SCREEN_UTILS_H
+
+#include "render.h"
+
+// returned by screens' next_wakeup when nothing changes until a key is pressed
+#define SCREEN_WAKEUP_IDLE -1
+
+void	 set_offset_yx(uint16_t height, uint16_t width, uint16_t *offset_y, uint16_t *offset_x);
+uint16_t get_fit_size(uint16_t size, uint16_t available, uint16_t taken);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,447 @@
+#include "screen_versus.h"
+#include "../common.h"
+#include "../input.h"
+#include "../versus.h"
+#include "cell_buffer.h"
+#include "compositor.h"
+#include "screen_utils.h"
+#include "stage_draw.h"
+
+extern float32_t	 g_delta_time;
+extern bool			 g_bag;
+extern board_size_t g_board_size;
+extern arena_t		 g_screens_arena;
+
+// each player laid out as the stage, mirrored: the boards on the sides, the
+// next shape and score windows in the middle
+static const uint8_t c_win_next_shape_width	 = 20;
+static const uint8_t c_win_next_shape_height = 11;
+static const uint8_t c_win_score_width		 = 20;
+static const uint8_t c_win_score_height		 = 11;
+static const uint8_t c_win_status_height	 = 2;
+
+static const uint8_t   c_win_padding					= 1;
+static const float32_t c_game_over_filled_rows_velocity = 0.05;
+
+typedef enum versus_status_t
+{
+	VERSUS_STATUS_PLAYING	= 0,
+	VERSUS_STATUS_PAUSED	= 1,
+	VERSUS_STATUS_OVER		= 2, // game over animation running
+	VERSUS_STATUS_COMPLETED = 3	 // waiting for a rematch
+} versus_status_t;
+
+typedef struct key_binding_t
+{
+	int				key;
+	uint8_t			player;
+	player_action_t action;
+} key_binding_t;
+
+// a player's windows and what they show
+typedef struct player_screen_t
+{
+	render_window_t win_board;
+	render_window_t win_next_shape;
+	render_window_t win_score;
+	cell_buffer_t	board_cells;
+	cell_buffer_t	next_shape_cells;
+	versus_view_t	view;
+	vec2i_t			board_view; // top left cell shown, boards larger than the window scroll
+	// values currently shown on the next shape and score windows
+	struct
+	{
+		uint32_t lines;
+		uint32_t garbage_sent;
+		uint32_t garbage_received;
+		uint8_t	 level;
+		uint8_t	 next_shape_type;
+		bool	 valid;
+	} hud;
+} player_screen_t;
+
+static const key_binding_t c_key_bindings[] = {
+	{ CH_P1_LEFT_L, 0, PLAYER_ACTION_MOVE_LEFT },
+	{ CH_P1_LEFT_U, 0, PLAYER_ACTION_MOVE_LEFT },
+	{ CH_P1_RIGHT_L, 0, PLAYER_ACTION_MOVE_RIGHT },
+	{ CH_P1_RIGHT_U, 0, PLAYER_ACTION_MOVE_RIGHT },
+	{ CH_P1_ROTATE_L, 0, PLAYER_ACTION_ROTATE },
+	{ CH_P1_ROTATE_U, 0, PLAYER_ACTION_ROTATE },
+	{ CH_P1_DOWN_L, 0, PLAYER_ACTION_SPEEDUP },
+	{ CH_P1_DOWN_U, 0, PLAYER_ACTION_SPEEDUP },
+	{ CH_SPACE, 0, PLAYER_ACTION_HARD_DROP },
+	{ CH_LEFT, 1, PLAYER_ACTION_MOVE_LEFT },
+	{ CH_RIGHT, 1, PLAYER_ACTION_MOVE_RIGHT },
+	{ CH_UP, 1, PLAYER_ACTION_ROTATE },
+	{ CH_DOWN, 1, PLAYER_ACTION_SPEEDUP },
+	{ CH_ENTER, 1, PLAYER_ACTION_HARD_DROP },
+};
+
+// the first player's moves are auto repeated too, only here: out of versus
+// 's' toggles the stage's shadow
+static const int c_repeat_keys[] = { CH_LEFT, CH_RIGHT, CH_DOWN, CH_P1_LEFT_L, CH_P1_RIGHT_L, CH_P1_DOWN_L };
+
+static player_screen_t players[VERSUS_PLAYERS];
+static render_window_t win_status;
+static uint16_t		   win_status_width;
+
+static versus_status_t status;
+static bool			   status_drawn;
+static bool			   paused;
+static bool			   rematch;
+static uint16_t		   game_over_filled_rows; // only drawn on the losers' boards
+static float32_t	   game_over_filled_rows_elapsed_time;
+
+// INIT
+static void create_windows(void);
+// UPDATE
+static void handle_input(void);
+static void process_game_over_filled_rows(void);
+static void update_status(void);
+// RENDER
+static void render_windows(void);
+static void render_win_board(player_screen_t *player);
+static void render_win_next_shape(player_screen_t *player);
+static void render_win_score(player_screen_t *player);
+static void render_win_status(void);
+
+void screen_versus_create(void)
+{
+	create_windows();
+}
+
+void screen_versus_destroy(void)
+{
+	for (uint8_t i = 0; i < VERSUS_PLAYERS; i++)
+	{
+		render_window_dispose(&players[i].win_board);
+		render_window_dispose(&players[i].win_next_shape);
+		render_window_dispose(&players[i].win_score);
+
+		cell_buffer_dispose(&players[i].board_cells);
+		cell_buffer_dispose(&players[i].next_shape_cells);
+	}
+
+	render_window_dispose(&win_status);
+}
+
+// a new match, the players' threads start right away
+void screen_versus_init(void)
+{
+	status							   = VERSUS_STATUS_PLAYING;
+	paused							   = false;
+	rematch							   = false;
+	game_over_filled_rows			   = 0;
+	game_over_filled_rows_elapsed_time = 0;
+
+	versus_start(time(NULL), g_bag ? RANDOMIZER_TYPE_BAG : RANDOMIZER_TYPE_UNIFORM, g_board_size);
+	input_set_repeat_keys(c_repeat_keys, sizeof(c_repeat_keys) / sizeof(c_repeat_keys[0]));
+
+	for (uint8_t i = 0; i < VERSUS_PLAYERS; i++)
+	{
+		versus_get_view(i, &players[i].view);
+		players[i].board_view = (vec2i_t){ 0 };
+	}
+
+	render_windows();
+}
+
+void screen_versus_dispose(void)
+{
+	versus_stop();
+	input_set_repeat_keys(NULL, 0);
+
+	for (uint8_t i = 0; i < VERSUS_PLAYERS; i++)
+	{
+		render_erase(&players[i].win_board);
+		compositor_submit(&players[i].win_board);
+
+		render_erase(&players[i].win_next_shape);
+		compositor_submit(&players[i].win_next_shape);
+
+		render_erase(&players[i].win_score);
+		compositor_submit(&players[i].win_score);
+	}
+
+	render_erase(&win_status);
+	compositor_submit(&win_status);
+}
+
+// once the game over animation is done and a rematch is asked for
+bool screen_versus_is_completed(void)
+{
+	return rematch;
+}
+
+// the games move on in their threads, frames only take a copy of them
+void screen_versus_update(void)
+{
+	handle_input();
+
+	for (uint8_t i = 0; i < VERSUS_PLAYERS; i++)
+	{
+		versus_get_view(i, &players[i].view);
+	}
+
+	if (versus_is_over())
+	{
+		process_game_over_filled_rows();
+	}
+
+	update_status();
+}
+
+void screen_versus_render(void)
+{
+	for (uint8_t i = 0; i < VERSUS_PLAYERS; i++)
+	{
+		render_win_next_shape(&players[i]);
+		render_win_score(&players[i]);
+		render_win_board(&players[i]);
+	}
+
+	if (!status_drawn)
+	{
+		render_win_status();
+	}
+}
+
+// every frame while the games run, they don't wait for keys. A rematch
+// starts on the next one
+float32_t screen_versus_next_wakeup(void)
+{
+	if (rematch)
+	{
+		return 0;
+	}
+
+	return status == VERSUS_STATUS_PAUSED || status == VERSUS_STATUS_COMPLETED ? SCREEN_WAKEUP_IDLE : 0;
+}
+
+void screen_versus_window_resized(void)
+{
+	render_windows();
+}
+
+// INIT
+// as the stage's, each player taking half of the terminal's width
+static void create_windows(void)
+{
+	uint16_t offset_y, offset_x;
+	uint16_t rows, cols;
+
+	render_get_size(&rows, &cols);
+
+	// board cells are two columns wide
+	uint16_t board_rows		  = get_fit_size(g_board_size.rows, rows, c_win_status_height + (c_win_padding * 2));
+	uint16_t board_cols		  = get_fit_size(g_board_size.cols, cols / (2 * VERSUS_PLAYERS), (c_win_next_shape_width / 2) + c_win_padding);
+	uint16_t win_board_height = board_rows + (c_win_padding * 2);
+	uint16_t win_board_width  = (board_cols * 2) + (c_win_padding * 2);
+	uint16_t win_height		  = win_board_height > c_win_next_shape_height + c_win_score_height ? win_board_height : c_win_next_shape_height + c_win_score_height;
+
+	win_status_width = (win_board_width + c_win_next_shape_width) * VERSUS_PLAYERS;
+
+	set_offset_yx(win_height + c_win_status_height, win_status_width, &offset_y, &offset_x);
+
+	for (uint8_t i = 0; i < VERSUS_PLAYERS; i++)
+	{
+		player_screen_t *player	 = &players[i];
+		uint16_t		 board_x = i == 0 ? offset_x : offset_x + win_status_width - win_board_width;
+		uint16_t		 side_x	 = i == 0 ? offset_x + win_board_width : offset_x + win_board_width + c_win_next_shape_width;
+
+		player->win_board = render_window_new(win_board_height, win_board_width, offset_y, board_x);
+
+		player->win_next_shape = render_window_new(c_win_next_shape_height, c_win_next_shape_width, offset_y, side_x);
+
+		player->win_score = render_window_new(c_win_score_height, c_win_score_width, offset_y + c_win_next_shape_height, side_x);
+
+		player->board_cells		 = cell_buffer_new(&g_screens_arena, &player->win_board, board_rows, board_cols * 2, c_win_padding, c_win_padding);
+		player->next_shape_cells = cell_buffer_new(&g_screens_arena, &player->win_next_shape, c_win_next_shape_height - 3, c_win_next_shape_width - 2, c_win_padding, c_win_padding);
+	}
+
+	win_status = render_window_new(c_win_status_height, win_status_width, offset_y + win_height, offset_x);
+}
+
+// UPDATE
+static void handle_input(void)
+{
+	for (uint8_t i = 0; i < input_get_keys_count(); i++)
+	{
+		int key = input_get_key(i);
+
+		if ((key == CH_PAUSE_L || key == CH_PAUSE_U) && !versus_is_over())
+		{
+			paused = !paused;
+			versus_set_paused(paused);
+		}
+		else if (key == CH_ENTER && status == VERSUS_STATUS_COMPLETED)
+		{
+			rematch = true;
+		}
+		else if (!paused)
+		{
+			for (uint8_t j = 0; j < sizeof(c_key_bindings) / sizeof(c_key_bindings[0]); j++)
+			{
+				if (c_key_bindings[j].key == key)
+				{
+					versus_push_action(c_key_bindings[j].player, c_key_bindings[j].action);
+				}
+			}
+		}
+	}
+}
+
+static void process_game_over_filled_rows(void)
+{
+	game_over_filled_rows_elapsed_time += g_delta_time;
+
+	if (game_over_filled_rows_elapsed_time >= c_game_over_filled_rows_velocity && game_over_filled_rows < players[0].board_cells.rows)
+	{
+		game_over_filled_rows_elapsed_time = 0;
+		game_over_filled_rows++;
+	}
+}
+
+static void update_status(void)
+{
+	versus_status_t next_status = paused ? VERSUS_STATUS_PAUSED : VERSUS_STATUS_PLAYING;
+
+	if (versus_is_over())
+	{
+		next_status = game_over_filled_rows >= players[0].board_cells.rows ? VERSUS_STATUS_COMPLETED : VERSUS_STATUS_OVER;
+	}
+
+	status_drawn = status_drawn && status == next_status;
+	status		 = next_status;
+}
+
+// RENDER
+static void render_windows(void)
+{
+	const char *next_shape_title = "NEXT";
+	const char *score_titles[]	 = { "PLAYER 1", "PLAYER 2" };
+	uint8_t		padding_x		 = c_win_padding * 2;
+
+	for (uint8_t i = 0; i < VERSUS_PLAYERS; i++)
+	{
+		player_screen_t *player = &players[i];
+
+		// board
+		render_box(&player->win_board, COLOR_PAIR(COLOR_PAIR_MAGENTA_MEDIUM));
+
+		// next shape
+		render_box(&player->win_next_shape, COLOR_PAIR(COLOR_PAIR_MAGENTA_MEDIUM));
+		render_text(&player->win_next_shape, 0, (c_win_next_shape_width * 0.5) - floor(strlen(next_shape_title) * 0.5), COLOR_PAIR(COLOR_PAIR_MAGENTA_HIGH), "%s", next_shape_title);
+		render_text(&player->win_next_shape, c_win_next_shape_height - 2, padding_x, COLOR_PAIR(COLOR_PAIR_GREEN_DEFAULT), "%s", "Level:");
+
+		// score
+		render_box(&player->win_score, COLOR_PAIR(COLOR_PAIR_MAGENTA_MEDIUM));
+		render_text(&player->win_score, 0, (c_win_score_width * 0.5) - floor(strlen(score_titles[i]) * 0.5), COLOR_PAIR(COLOR_PAIR_MAGENTA_HIGH), "%s", score_titles[i]);
+		render_text(&player->win_score, c_win_padding * 2, padding_x, 0, "%s", "Lines:");
+		render_text(&player->win_score, (c_win_padding * 2) + 1, padding_x, COLOR_PAIR(COLOR_PAIR_GREEN_DEFAULT), "%s", "Sent:");
+		render_text(&player->win_score, (c_win_padding * 2) + 2, padding_x, COLOR_PAIR(COLOR_PAIR_RED_DEFAULT), "%s", "Received:");
+
+		render_touch(&player->win_board);
+		render_touch(&player->win_next_shape);
+		render_touch(&player->win_score);
+		compositor_submit(&player->win_board);
+		compositor_submit(&player->win_next_shape);
+		compositor_submit(&player->win_score);
+
+		cell_buffer_invalidate(&player->board_cells);
+		cell_buffer_invalidate(&player->next_shape_cells);
+		player->hud.valid = false;
+	}
+
+	status_drawn = false;
+}
+
+// the white rows of the game over animation only show on a lost game
+static void render_win_board(player_screen_t *player)
+{
+	stage_draw_follow_shape(&player->board_cells, &player->view.engine, &player->board_view);
+
+	cell_buffer_clear(&player->board_cells);
+	stage_draw_board(&player->board_cells, &player->view.engine, player->board_view, game_over_filled_rows);
+	cell_buffer_flush(&player->board_cells);
+
+	compositor_submit(&player->win_board);
+}
+
+static void render_win_next_shape(player_screen_t *player)
+{
+	const engine_t *engine = &player->view.engine;
+
+	if (player->hud.valid && player->hud.level == engine->level && player->hud.next_shape_type == engine->next_shape.type)
+	{
+		return;
+	}
+
+	player->hud.level			= engine->level;
+	player->hud.next_shape_type = engine->next_shape.type;
+
+	render_text(&player->win_next_shape, c_win_next_shape_height - 2, strlen("Level:") + (c_win_padding * 2) + 1, COLOR_PAIR(COLOR_PAIR_GREEN_DEFAULT), "%-3d", engine->level);
+	cell_buffer_clear(&player->next_shape_cells);
+	stage_draw_next_shape(&player->next_shape_cells, &engine->next_shape, c_win_next_shape_height, c_win_next_shape_width);
+	cell_buffer_flush(&player->next_shape_cells);
+
+	compositor_submit(&player->win_next_shape);
+}
+
+static void render_win_score(player_screen_t *player)
+{
+	const versus_view_t *view	   = &player->view;
+	uint8_t				 padding_x = strlen("Received:") + (c_win_padding * 2) + 1;
+	uint8_t				 padding_y = c_win_padding * 2;
+
+	if (player->hud.valid &&
+		player->hud.lines == view->engine.lines &&
+		player->hud.garbage_sent == view->garbage_sent &&
+		player->hud.garbage_received == view->garbage_received)
+	{
+		return;
+	}
+
+	player->hud.lines			 = view->engine.lines;
+	player->hud.garbage_sent	 = view->garbage_sent;
+	player->hud.garbage_received = view->garbage_received;
+	player->hud.valid			 = true;
+
+	render_text(&player->win_score, padding_y, padding_x, 0, "%-5u", view->engine.lines);
+	render_text(&player->win_score, padding_y + 1, padding_x, COLOR_PAIR(COLOR_PAIR_GREEN_DEFAULT), "%-5u", view->garbage_sent);
+	render_text(&player->win_score, padding_y + 2, padding_x, COLOR_PAIR(COLOR_PAIR_RED_DEFAULT), "%-5u", view->garbage_received);
+
+	compositor_submit(&player->win_score);
+}
+
+static void render_win_status(void)
+{
+	const char *keys_label_p1 = "*player 1: a d w s, space to drop";
+	const char *keys_label_p2 = "player 2: arrows, enter to drop*";
+	bool		lost_p1		  = engine_is_game_over(&players[0].view.engine);
+	bool		lost_p2		  = engine_is_game_over(&players[1].view.engine);
+	const char *result		  = lost_p1 && lost_p2 ? "*draw" : lost_p1 ? "*player 2 wins" : "*player 1 wins";
+
+	render_erase(&win_status);
+	render_text(&win_status, 0, 0, 0, "%s", keys_label_p1);
+	render_text(&win_status, 0, win_status_width - strlen(keys_label_p2), 0, "%s", keys_label_p2);
+
+	switch (status)
+	{
+	case VERSUS_STATUS_PLAYING:
+		render_text(&win_status, 1, 0, 0, "%s", "*press (p) to pause");
+		break;
+	case VERSUS_STATUS_PAUSED:
+		render_text(&win_status, 1, 0, COLOR_PAIR(COLOR_PAIR_YELLOW_DEFAULT), "%s", "*paused, press (p) to go on");
+		break;
+	case VERSUS_STATUS_OVER:
+		render_text(&win_status, 1, 0, COLOR_PAIR(COLOR_PAIR_GREEN_DEFAULT), "%s", result);
+		break;
+	case VERSUS_STATUS_COMPLETED:
+		render_text(&win_status, 1, 0, COLOR_PAIR(COLOR_PAIR_GREEN_DEFAULT), "%s, press (enter) for a rematch", result);
+		break;
+	}
+
+	status_drawn = true;
+	compositor_submit(&win_status);
+}
\ No newline at end of file
@@ -0,0 +1,16 @@
+#ifndef SCREEN_VERSUS_H
+#define SCREEN_VERSUS_H
+
+#include "../defs.h"
+
+void		screen_versus_create(void);
+void		screen_versus_destroy(void);
+void		screen_versus_init(void);
+void		screen_versus_dispose(void);
+bool		screen_versus_is_completed(void);
+void		screen_versus_update(void);
+void		screen_versus_render(void);
+float32_t	screen_versus_next_wakeup(void);
+void		screen_versus_window_resized(void);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,319 @@
+#include "screen_watch.h"
+#include "../common.h"
+#include "../engine/engine.h"
+#include "../watch.h"
+#include "cell_buffer.h"
+#include "compositor.h"
+#include "screen_utils.h"
+
+extern float32_t g_delta_time;
+extern char		*g_watch_path;
+
+// laid out as the stage's
+static const uint8_t   c_win_next_shape_width  = 20;
+static const uint8_t   c_win_next_shape_height = 11;
+static const uint8_t   c_win_score_width	   = 20;
+static const uint8_t   c_win_score_height	   = 11;
+static const uint8_t   c_win_status_height	   = 2;
+static const uint8_t   c_win_padding		   = 1;
+static const float32_t c_reconnect_interval	   = 1.0;
+
+typedef enum watch_status_t
+{
+	WATCH_STATUS_WAITING   = 0, // for a game to connect to
+	WATCH_STATUS_WATCHING  = 1,
+	WATCH_STATUS_PAUSED	   = 2,
+	WATCH_STATUS_GAME_OVER = 3
+} watch_status_t;
+
+static render_window_t win_board;
+static render_window_t win_next_shape;
+static render_window_t win_score;
+static render_window_t win_status;
+
+static cell_buffer_t board_cells;
+static cell_buffer_t next_shape_cells;
+
+static watch_t		   watch;
+static watch_status_t  status;
+static uint16_t		   board_rows; // of the board panel the windows were created for
+static uint16_t		   board_cols;
+static float32_t	   reconnect_time_left;
+static uint32_t		   messages_drawn; // applied when the panels were last drawn
+static bool			   panels_drawn;
+static broadcast_hud_t hud; // what the score panel shows
+static bool			   hud_drawn;
+static bool			   status_drawn;
+
+static void create_windows(uint16_t rows, uint16_t cols);
+static void destroy_windows(void);
+static void erase_windows(void);
+static void render_windows(void);
+static void render_panel(cell_buffer_t *buffer, const watch_panel_t *panel);
+static void render_win_score(void);
+static void render_win_status(void);
+
+// sized for the default board until a game with another one is watched
+void screen_watch_create(void)
+{
+	create_windows(BOARD_ROWS_DEFAULT, BOARD_COLS_DEFAULT * 2);
+	watch_init(&watch);
+}
+
+void screen_watch_destroy(void)
+{
+	destroy_windows();
+	watch_dispose(&watch);
+}
+
+void screen_watch_init(void)
+{
+	status				= WATCH_STATUS_WAITING;
+	reconnect_time_left = 0;
+
+	render_windows();
+}
+
+void screen_watch_dispose(void)
+{
+	watch_close(&watch);
+	erase_windows();
+}
+
+// until the watcher quits
+bool screen_watch_is_completed(void)
+{
+	return false;
+}
+
+// connects again every c_reconnect_interval while nobody is broadcasting,
+// e.g. until the game starts or after it quit
+void screen_watch_update(void)
+{
+	watch_status_t next_status = WATCH_STATUS_WAITING;
+
+	if (watch.fd < 0)
+	{
+		reconnect_time_left -= g_delta_time;
+
+		if (reconnect_time_left <= 0)
+		{
+			reconnect_time_left = c_reconnect_interval;
+			watch_connect(&watch, g_watch_path);
+		}
+	}
+
+	if (watch_update(&watch) && watch.synced)
+	{
+		next_status = watch.hud.game_over ? WATCH_STATUS_GAME_OVER : watch.hud.paused ? WATCH_STATUS_PAUSED : WATCH_STATUS_WATCHING;
+	}
+
+	status_drawn = status_drawn && status == next_status;
+	status		 = next_status;
+}
+
+// only when a message changed the panels, the last ones stay on screen
+// while waiting. The windows are created again when the board watched has
+// another size
+void screen_watch_render(void)
+{
+	const watch_panel_t *board_panel = &watch.panels[BROADCAST_PANEL_BOARD];
+
+	if (watch.synced && (board_panel->rows != board_rows || board_panel->cols != board_cols))
+	{
+		erase_windows();
+		destroy_windows();
+		create_windows(board_panel->rows, board_panel->cols);
+		render_windows();
+	}
+
+	if (!panels_drawn || messages_drawn != watch.messages)
+	{
+		messages_drawn = watch.messages;
+		panels_drawn   = true;
+
+		render_panel(&board_cells, &watch.panels[BROADCAST_PANEL_BOARD]);
+		compositor_submit(&win_board);
+
+		render_panel(&next_shape_cells, &watch.panels[BROADCAST_PANEL_NEXT_SHAPE]);
+		compositor_submit(&win_next_shape);
+	}
+
+	if (!hud_drawn || memcmp(&hud, &watch.hud, sizeof(hud)) != 0)
+	{
+		render_win_score();
+	}
+
+	if (!status_drawn)
+	{
+		render_win_status();
+	}
+}
+
+// woken up by the messages, otherwise when it's time to connect again
+float32_t screen_watch_next_wakeup(void)
+{
+	return watch.fd >= 0 ? SCREEN_WAKEUP_IDLE : reconnect_time_left;
+}
+
+void screen_watch_window_resized(void)
+{
+	render_windows();
+}
+
+// readable when a message comes, -1 while not connected
+int screen_watch_get_wait_fd(void)
+{
+	return watch.fd;
+}
+
+// INIT
+// as the stage's, for a board panel of rows by cols (two columns per board
+// cell). What doesn't fit the terminal is cut
+static void create_windows(uint16_t rows, uint16_t cols)
+{
+	uint16_t offset_y, offset_x;
+	uint16_t term_rows, term_cols;
+
+	render_get_size(&term_rows, &term_cols);
+
+	uint16_t cells_rows		  = get_fit_size(rows, term_rows, c_win_status_height + (c_win_padding * 2));
+	uint16_t cells_cols		  = get_fit_size(cols / 2, term_cols / 2, (c_win_next_shape_width / 2) + c_win_padding) * 2;
+	uint16_t win_board_height = cells_rows + (c_win_padding * 2);
+	uint16_t win_board_width  = cells_cols + (c_win_padding * 2);
+	uint16_t win_height		  = win_board_height > c_win_next_shape_height + c_win_score_height ? win_board_height : c_win_next_shape_height + c_win_score_height;
+
+	board_rows = rows;
+	board_cols = cols;
+
+	set_offset_yx(win_height + c_win_status_height, win_board_width + c_win_next_shape_width, &offset_y, &offset_x);
+	win_board = render_window_new(win_board_height, win_board_width, offset_y, offset_x);
+
+	win_next_shape = render_window_new(c_win_next_shape_height, c_win_next_shape_width, offset_y, offset_x + win_board_width);
+
+	win_score = render_window_new(c_win_score_height, c_win_score_width, offset_y + c_win_next_shape_height, offset_x + win_board_width);
+
+	win_status = render_window_new(c_win_status_height, win_board_width + c_win_next_shape_width, offset_y + win_height, offset_x);
+
+	// on the heap, created again for every board size watched
+	board_cells		 = cell_buffer_new(NULL, &win_board, cells_rows, cells_cols, c_win_padding, c_win_padding);
+	next_shape_cells = cell_buffer_new(NULL, &win_next_shape, c_win_next_shape_height - 3, c_win_next_shape_width - 2, c_win_padding, c_win_padding);
+}
+
+static void destroy_windows(void)
+{
+	render_window_dispose(&win_board);
+	render_window_dispose(&win_next_shape);
+	render_window_dispose(&win_score);
+	render_window_dispose(&win_status);
+
+	cell_buffer_dispose(&board_cells);
+	cell_buffer_dispose(&next_shape_cells);
+}
+
+// RENDER
+static void erase_windows(void)
+{
+	render_erase(&win_board);
+	compositor_submit(&win_board);
+
+	render_erase(&win_next_shape);
+	compositor_submit(&win_next_shape);
+
+	render_erase(&win_score);
+	compositor_submit(&win_score);
+
+	render_erase(&win_status);
+	compositor_submit(&win_status);
+}
+
+static void render_windows(void)
+{
+	const char *next_shape_title = "NEXT";
+	const char *score_title		 = "SCORE";
+	uint8_t		padding_x		 = c_win_padding * 2;
+
+	render_box(&win_board, COLOR_PAIR(COLOR_PAIR_MAGENTA_MEDIUM));
+
+	render_box(&win_next_shape, COLOR_PAIR(COLOR_PAIR_MAGENTA_MEDIUM));
+	render_text(&win_next_shape, 0, (c_win_next_shape_width * 0.5) - floor(strlen(next_shape_title) * 0.5), COLOR_PAIR(COLOR_PAIR_MAGENTA_HIGH), "%s", next_shape_title);
+	render_text(&win_next_shape, c_win_next_shape_height - 2, padding_x, COLOR_PAIR(COLOR_PAIR_GREEN_DEFAULT), "%s", "Level:");
+
+	render_box(&win_score, COLOR_PAIR(COLOR_PAIR_MAGENTA_MEDIUM));
+	render_text(&win_score, 0, (c_win_score_width * 0.5) - floor(strlen(score_title) * 0.5), COLOR_PAIR(COLOR_PAIR_MAGENTA_HIGH), "%s", score_title);
+	render_text(&win_score, c_win_padding * 2, padding_x, 0, "%s", "Current:");
+	render_text(&win_score, (c_win_padding * 2) + 1, padding_x, COLOR_PAIR(COLOR_PAIR_GREEN_DEFAULT), "%s", "Top:");
+
+	render_touch(&win_board);
+	render_touch(&win_next_shape);
+	render_touch(&win_score);
+	compositor_submit(&win_board);
+	compositor_submit(&win_next_shape);
+	compositor_submit(&win_score);
+
+	cell_buffer_invalidate(&board_cells);
+	cell_buffer_invalidate(&next_shape_cells);
+	panels_drawn = false;
+	hud_drawn	 = false;
+	status_drawn = false;
+}
+
+// what doesn't fit the window (a bigger board) is cut
+static void render_panel(cell_buffer_t *buffer, const watch_panel_t *panel)
+{
+	uint16_t rows = panel->rows < buffer->rows ? panel->rows : buffer->rows;
+	uint16_t cols = panel->cols < buffer->cols ? panel->cols : buffer->cols;
+
+	cell_buffer_clear(buffer);
+
+	for (uint16_t y = 0; y < rows; y++)
+	{
+		for (uint16_t x = 0; x < cols; x++)
+		{
+			buffer->cells[buffer->cols * y + x] = broadcast_decode_cell(panel->cells[panel->cols * y + x]);
+		}
+	}
+
+	cell_buffer_flush(buffer);
+}
+
+static void render_win_score(void)
+{
+	uint8_t padding_x = strlen("Current:") + (c_win_padding * 2) + 1,
+			padding_y = c_win_padding * 2;
+
+	hud			 = watch.hud;
+	hud_drawn	 = true;
+	status_drawn = false; // shows the user
+
+	render_text(&win_next_shape, c_win_next_shape_height - 2, strlen("Level:") + (c_win_padding * 2) + 1, COLOR_PAIR(COLOR_PAIR_GREEN_DEFAULT), "%-3d", hud.level);
+	render_text(&win_score, padding_y, padding_x, 0, "%-5d", hud.score);
+	render_text(&win_score, padding_y + 1, padding_x, COLOR_PAIR(COLOR_PAIR_GREEN_DEFAULT), "%-5d", hud.record);
+
+	compositor_submit(&win_next_shape);
+	compositor_submit(&win_score);
+}
+
+static void render_win_status(void)
+{
+	render_erase(&win_status);
+
+	switch (status)
+	{
+	case WATCH_STATUS_WAITING:
+		render_text(&win_status, 0, 0, 0, "*waiting for a game on %s", g_watch_path);
+		break;
+	case WATCH_STATUS_WATCHING:
+		render_text(&win_status, 0, 0, 0, "*watching %s", hud.user);
+		break;
+	case WATCH_STATUS_PAUSED:
+		render_text(&win_status, 0, 0, COLOR_PAIR(COLOR_PAIR_YELLOW_DEFAULT), "*%s paused the game", hud.user);
+		break;
+	case WATCH_STATUS_GAME_OVER:
+		render_text(&win_status, 0, 0, COLOR_PAIR(COLOR_PAIR_RED_DEFAULT), "*game over for %s", hud.user);
+		break;
+	}
+
+	status_drawn = true;
+	compositor_submit(&win_status);
+}
\ No newline at end of file
@@ -0,0 +1,17 @@
+#ifndef SCREEN_WATCH_H
+#define SCREEN_WATCH_H
+
+#include "../defs.h"
+
+void		screen_watch_create(void);
+void		screen_watch_destroy(void);
+void		screen_watch_init(void);
+void		screen_watch_dispose(void);
+bool		screen_watch_is_completed(void);
+void		screen_watch_update(void);
+void		screen_watch_render(void);
+float32_t	screen_watch_next_wakeup(void);
+void		screen_watch_window_resized(void);
+int			screen_watch_get_wait_fd(void);
+
+#endif
\ No newline at end of file
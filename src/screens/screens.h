@@ -1,3 +1,8 @@
+#include "compositor.h"
+#include "render_curses.h"
 #include "screen_game_over.h"
 #include "screen_init.h"
 #include "screen_stage.h"
+#include "screen_utils.h"
+#include "screen_versus.h"
+#include "screen_watch.h"
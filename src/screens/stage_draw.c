@@ -0,0 +1,161 @@
+#include "stage_draw.h"
+
+static void draw_cell(cell_buffer_t *buffer, int16_t y, int16_t x, chtype left, chtype right, uint8_t color);
+
+// the falling shape (and its shadow) over the locked blocks, as much of the
+// board from view as fits on the buffer. The bottom game_over_filled_rows
+// rows shown are white once the game is over
+void stage_draw_board(cell_buffer_t *buffer, const engine_t *engine, vec2i_t view, uint16_t game_over_filled_rows)
+{
+	const shape_rotation_t *prev_rotation	= SHAPE_ROTATION(engine->prev_shape);
+	int16_t					prev_shape_left = engine->prev_shape.pos.x + prev_rotation->padding_left;
+	int16_t					prev_shape_top	= engine->prev_shape.pos.y + prev_rotation->padding_top;
+	int16_t					top_y			= view.y > engine->board_top_row_filled ? view.y : engine->board_top_row_filled;
+	int16_t					bottom_y		= view.y + buffer->rows < engine->board_size.rows ? view.y + buffer->rows : engine->board_size.rows;
+	int16_t					right_x			= view.x + (buffer->cols / 2) < engine->board_size.cols ? view.x + (buffer->cols / 2) : engine->board_size.cols;
+	uint8_t					color			= 0;
+
+	stage_draw_shape(buffer, &engine->current_shape, engine->current_shape.pos.y - view.y, (engine->current_shape.pos.x - view.x) * 2, engine->shape_shadow_enabled);
+
+	for (int16_t y = bottom_y - 1; y >= top_y; y--)
+	{
+		bool game_over_row = engine->board_top_row_filled == 0 && game_over_filled_rows >= (bottom_y - y);
+
+		// nothing to draw on empty rows
+		if (!engine->board[y] && !game_over_row)
+		{
+			continue;
+		}
+
+		for (int16_t x = view.x; x < right_x; x++)
+		{
+			// white rows for game over animation
+			if (game_over_row)
+			{
+				draw_cell(buffer, y - view.y, x - view.x, CH_SHAPE_FILL, CH_SHAPE_FILL, COLOR_PAIR_WHITE_HIGH);
+			}
+			else
+			{
+				color = engine->board_colors[engine->board_size.cols * y + x];
+
+				if (!color)
+				{
+					continue;
+				}
+
+				bool filled_row = FIXED_SPARSE_SET_CONTAINS(engine->filled_rows_indexes, y);
+
+				// white highlight for filled (completed) rows
+				if (filled_row)
+				{
+					color = COLOR_PAIR_WHITE_HIGH - ((uint8_t)((engine->filled_rows_elapsed_time) * 10) % 3);
+					draw_cell(buffer, y - view.y, x - view.x, CH_SHAPE_FILL, CH_SHAPE_FILL, color);
+				}
+				// highlight animation for last shape
+				else if (engine->prev_shape_active &&
+						 (x >= prev_shape_left) &&
+						 (x < (prev_shape_left + prev_rotation->width)) &&
+						 (y >= prev_shape_top) &&
+						 (y < (prev_shape_top + prev_rotation->height)) &&
+						 (prev_rotation->masks[y - prev_shape_top] & (1 << (x - prev_shape_left))))
+				{
+					color = (color * 10) + ((uint8_t)((engine->prev_shape_elapsed_time) * 10) % 3);
+					draw_cell(buffer, y - view.y, x - view.x, CH_SHAPE_FILL, CH_SHAPE_FILL, color);
+				}
+				// defaul blocks color
+				else
+				{
+					draw_cell(buffer, y - view.y, x - view.x, '[', ']', color);
+				}
+			}
+		}
+	}
+}
+
+// scrolls the view as little as needed to show the falling shape and, as far
+// as it fits below it, where it lands. A board that fits never scrolls
+void stage_draw_follow_shape(const cell_buffer_t *buffer, const engine_t *engine, vec2i_t *view)
+{
+	const shape_t			*shape	  = &engine->current_shape;
+	const shape_rotation_t *rotation = SHAPE_ROTATION(*shape);
+	int16_t					rows	 = buffer->rows;
+	int16_t					cols	 = buffer->cols / 2;
+	int16_t					top		 = shape->pos.y + rotation->padding_top;
+	int16_t					bottom	 = engine_get_shape_dest_pos_y(engine) + rotation->padding_top + rotation->height;
+	int16_t					left	 = shape->pos.x + rotation->padding_left;
+	int16_t					right	 = left + rotation->width;
+
+	bottom = bottom - top > rows ? top + rows : bottom;
+
+	if (top < view->y)
+	{
+		view->y = top;
+	}
+	else if (bottom > view->y + rows)
+	{
+		view->y = bottom - rows;
+	}
+
+	if (left < view->x)
+	{
+		view->x = left;
+	}
+	else if (right > view->x + cols)
+	{
+		view->x = right - cols;
+	}
+
+	view->y = view->y + rows > engine->board_size.rows ? engine->board_size.rows - rows : view->y;
+	view->x = view->x + cols > engine->board_size.cols ? engine->board_size.cols - cols : view->x;
+	view->y = view->y > 0 ? view->y : 0;
+	view->x = view->x > 0 ? view->x : 0;
+}
+
+// centered on a window of the given size, the buffer being inside it
+void stage_draw_next_shape(cell_buffer_t *buffer, const shape_t *shape, uint8_t win_height, uint8_t win_width)
+{
+	const shape_rotation_t *rotation = SHAPE_ROTATION(*shape);
+
+	stage_draw_shape(buffer,
+					 shape,
+					 (win_height - rotation->height) / 2 - rotation->padding_top - buffer->offset_y,
+					 win_width / 2 - rotation->width - (rotation->padding_left * 2) - buffer->offset_x,
+					 false);
+}
+
+void stage_draw_shape(cell_buffer_t *buffer, const shape_t *shape, int16_t y, int16_t x, bool shadow)
+{
+	const shape_rotation_t *rotation = SHAPE_ROTATION(*shape);
+	uint8_t					color	 = c_shape_colors[shape->type];
+	int16_t					shadow_y = y + (shape->shadow_pos_y - shape->pos.y);
+
+	y += rotation->padding_top;
+	x += rotation->padding_left * 2;
+	shadow_y += rotation->padding_top;
+
+	for (uint8_t row = 0; row < rotation->height; row++)
+	{
+		for (uint8_t col = 0; col < rotation->width; col++)
+		{
+			bool filled = rotation->masks[row] & (1 << col);
+
+			if (filled && shadow)
+			{
+				CELL_BUFFER_SET(*buffer, shadow_y + row, x + (col * 2), '[' | COLOR_PAIR(color * 10));
+				CELL_BUFFER_SET(*buffer, shadow_y + row, x + (col * 2) + 1, ']' | COLOR_PAIR(color * 10));
+			}
+
+			if (filled)
+			{
+				CELL_BUFFER_SET(*buffer, y + row, x + (col * 2), '[' | COLOR_PAIR(color));
+				CELL_BUFFER_SET(*buffer, y + row, x + (col * 2) + 1, ']' | COLOR_PAIR(color));
+			}
+		}
+	}
+}
+
+static void draw_cell(cell_buffer_t *buffer, int16_t y, int16_t x, chtype left, chtype right, uint8_t color)
+{
+	CELL_BUFFER_SET(*buffer, y, x * 2, left | COLOR_PAIR(color));
+	CELL_BUFFER_SET(*buffer, y, (x * 2) + 1, right | COLOR_PAIR(color));
+}
\ No newline at end of file
@@ -0,0 +1,16 @@
+#ifndef STAGE_DRAW_H
+#define STAGE_DRAW_H
+
+#include "../engine/engine.h"
+#include "cell_buffer.h"
+
+// a game drawn as the stage shows it, for every screen with a board. They
+// only depend on the engine given, a board cell is two columns wide. Boards
+// larger than their buffer are drawn from a view, the board cell shown on the
+// buffer's top left corner
+void stage_draw_board(cell_buffer_t *buffer, const engine_t *engine, vec2i_t view, uint16_t game_over_filled_rows);
+void stage_draw_follow_shape(const cell_buffer_t *buffer, const engine_t *engine, vec2i_t *view);
+void stage_draw_next_shape(cell_buffer_t *buffer, const shape_t *shape, uint8_t win_height, uint8_t win_width);
+void stage_draw_shape(cell_buffer_t *buffer, const shape_t *shape, int16_t y, int16_t x, bool shadow);
+
+#endif
\ No newline at end of file
@@ -1,64 +1,92 @@
 #ifndef SHAPES_H
 #define SHAPES_H
 
-#include "defs.h"
+#include "types.h"
 
 #define SHAPES_COUNT 7
 #define SHAPE_MAX_SIZE 4
+#define SHAPE_ROTATIONS_COUNT 4
 
-const bool c_shape_i[] = {
-	1, 0, 0, 0,
-	1, 0, 0, 0,
-	1, 0, 0, 0,
-	1, 0, 0, 0
-};
-
-const bool c_shape_o[] = {
-	1, 1,
-	1, 1
-};
-
-const bool c_shape_t[] = {
-	0, 1, 0,
-	1, 1, 1,
-	0, 0, 0
-};
-
-const bool c_shape_j[] = {
-	0, 1, 0,
-	0, 1, 0,
-	1, 1, 0
-};
-
-const bool c_shape_l[] = {
-	1, 0, 0,
-	1, 0, 0,
-	1, 1, 0
-};
+#define SHAPE_ROTATION(shape) (&c_shape_rotations[(shape).type][(shape).rotation])
 
-const bool c_shape_s[] = {
-	0, 1, 1,
-	1, 1, 0,
-	0, 0, 0
-};
+typedef enum shape_type_t
+{
+	SHAPE_TYPE_I = 0,
+	SHAPE_TYPE_O = 1,
+	SHAPE_TYPE_T = 2,
+	SHAPE_TYPE_J = 3,
+	SHAPE_TYPE_L = 4,
+	SHAPE_TYPE_S = 5,
+	SHAPE_TYPE_Z = 6
+} shape_type_t;
 
-const bool c_shape_z[] = {
-	1, 1, 0,
-	0, 1, 1,
-	0, 0, 0
-};
+// one orientation of a shape inside its SHAPE_MAX_SIZE box. masks hold one bit
+// per filled cell (bit x is column x), rows and cols trimmed by the paddings
+typedef struct shape_rotation_t
+{
+	uint8_t masks[SHAPE_MAX_SIZE];
+	uint8_t padding_left;
+	uint8_t padding_right;
+	uint8_t padding_top;
+	uint8_t padding_bottom;
+	uint8_t width;
+	uint8_t height;
+} shape_rotation_t;
 
-const bool *c_shape_list[] = {
-	c_shape_i,
-	c_shape_o,
-	c_shape_t,
-	c_shape_j,
-	c_shape_l,
-	c_shape_s,
-	c_shape_z
+// clockwise rotations, index 0 is the spawn orientation
+static const shape_rotation_t c_shape_rotations[SHAPES_COUNT][SHAPE_ROTATIONS_COUNT] = {
+	// I
+	{
+		{ .masks = { 0x1, 0x1, 0x1, 0x1 }, .padding_left = 0, .padding_right = 3, .padding_top = 0, .padding_bottom = 0, .width = 1, .height = 4 },
+		{ .masks = { 0xF, 0x0, 0x0, 0x0 }, .padding_left = 0, .padding_right = 0, .padding_top = 0, .padding_bottom = 3, .width = 4, .height = 1 },
+		{ .masks = { 0x1, 0x1, 0x1, 0x1 }, .padding_left = 3, .padding_right = 0, .padding_top = 0, .padding_bottom = 0, .width = 1, .height = 4 },
+		{ .masks = { 0xF, 0x0, 0x0, 0x0 }, .padding_left = 0, .padding_right = 0, .padding_top = 3, .padding_bottom = 0, .width = 4, .height = 1 },
+	},
+	// O
+	{
+		{ .masks = { 0x3, 0x3, 0x0, 0x0 }, .padding_left = 0, .padding_right = 0, .padding_top = 0, .padding_bottom = 0, .width = 2, .height = 2 },
+		{ .masks = { 0x3, 0x3, 0x0, 0x0 }, .padding_left = 0, .padding_right = 0, .padding_top = 0, .padding_bottom = 0, .width = 2, .height = 2 },
+		{ .masks = { 0x3, 0x3, 0x0, 0x0 }, .padding_left = 0, .padding_right = 0, .padding_top = 0, .padding_bottom = 0, .width = 2, .height = 2 },
+		{ .masks = { 0x3, 0x3, 0x0, 0x0 }, .padding_left = 0, .padding_right = 0, .padding_top = 0, .padding_bottom = 0, .width = 2, .height = 2 },
+	},
+	// T
+	{
+		{ .masks = { 0x2, 0x7, 0x0, 0x0 }, .padding_left = 0, .padding_right = 0, .padding_top = 0, .padding_bottom = 1, .width = 3, .height = 2 },
+		{ .masks = { 0x1, 0x3, 0x1, 0x0 }, .padding_left = 1, .padding_right = 0, .padding_top = 0, .padding_bottom = 0, .width = 2, .height = 3 },
+		{ .masks = { 0x7, 0x2, 0x0, 0x0 }, .padding_left = 0, .padding_right = 0, .padding_top = 1, .padding_bottom = 0, .width = 3, .height = 2 },
+		{ .masks = { 0x2, 0x3, 0x2, 0x0 }, .padding_left = 0, .padding_right = 1, .padding_top = 0, .padding_bottom = 0, .width = 2, .height = 3 },
+	},
+	// J
+	{
+		{ .masks = { 0x2, 0x2, 0x3, 0x0 }, .padding_left = 0, .padding_right = 1, .padding_top = 0, .padding_bottom = 0, .width = 2, .height = 3 },
+		{ .masks = { 0x1, 0x7, 0x0, 0x0 }, .padding_left = 0, .padding_right = 0, .padding_top = 0, .padding_bottom = 1, .width = 3, .height = 2 },
+		{ .masks = { 0x3, 0x1, 0x1, 0x0 }, .padding_left = 1, .padding_right = 0, .padding_top = 0, .padding_bottom = 0, .width = 2, .height = 3 },
+		{ .masks = { 0x7, 0x4, 0x0, 0x0 }, .padding_left = 0, .padding_right = 0, .padding_top = 1, .padding_bottom = 0, .width = 3, .height = 2 },
+	},
+	// L
+	{
+		{ .masks = { 0x1, 0x1, 0x3, 0x0 }, .padding_left = 0, .padding_right = 1, .padding_top = 0, .padding_bottom = 0, .width = 2, .height = 3 },
+		{ .masks = { 0x7, 0x1, 0x0, 0x0 }, .padding_left = 0, .padding_right = 0, .padding_top = 0, .padding_bottom = 1, .width = 3, .height = 2 },
+		{ .masks = { 0x3, 0x2, 0x2, 0x0 }, .padding_left = 1, .padding_right = 0, .padding_top = 0, .padding_bottom = 0, .width = 2, .height = 3 },
+		{ .masks = { 0x4, 0x7, 0x0, 0x0 }, .padding_left = 0, .padding_right = 0, .padding_top = 1, .padding_bottom = 0, .width = 3, .height = 2 },
+	},
+	// S
+	{
+		{ .masks = { 0x6, 0x3, 0x0, 0x0 }, .padding_left = 0, .padding_right = 0, .padding_top = 0, .padding_bottom = 1, .width = 3, .height = 2 },
+		{ .masks = { 0x1, 0x3, 0x2, 0x0 }, .padding_left = 1, .padding_right = 0, .padding_top = 0, .padding_bottom = 0, .width = 2, .height = 3 },
+		{ .masks = { 0x6, 0x3, 0x0, 0x0 }, .padding_left = 0, .padding_right = 0, .padding_top = 1, .padding_bottom = 0, .width = 3, .height = 2 },
+		{ .masks = { 0x1, 0x3, 0x2, 0x0 }, .padding_left = 0, .padding_right = 1, .padding_top = 0, .padding_bottom = 0, .width = 2, .height = 3 },
+	},
+	// Z
+	{
+		{ .masks = { 0x3, 0x6, 0x0, 0x0 }, .padding_left = 0, .padding_right = 0, .padding_top = 0, .padding_bottom = 1, .width = 3, .height = 2 },
+		{ .masks = { 0x2, 0x3, 0x1, 0x0 }, .padding_left = 1, .padding_right = 0, .padding_top = 0, .padding_bottom = 0, .width = 2, .height = 3 },
+		{ .masks = { 0x3, 0x6, 0x0, 0x0 }, .padding_left = 0, .padding_right = 0, .padding_top = 1, .padding_bottom = 0, .width = 3, .height = 2 },
+		{ .masks = { 0x2, 0x3, 0x1, 0x0 }, .padding_left = 0, .padding_right = 1, .padding_top = 0, .padding_bottom = 0, .width = 2, .height = 3 },
+	},
 };
 
-const uint8_t c_shape_colors[] = {
+static const uint8_t c_shape_colors[] = {
 	COLOR_PAIR_CYAN_DEFAULT,
 	COLOR_PAIR_YELLOW_DEFAULT,
 	COLOR_PAIR_WHITE_DEFAULT,
@@ -68,35 +96,13 @@ const uint8_t c_shape_colors[] = {
 	COLOR_PAIR_RED_DEFAULT
 };
 
-const uint8_t c_shape_size[] = {
-	4, 2, 3, 3, 3, 3, 3
-};
-
-typedef enum shape_type_t
-{
-	SHAPE_TYPE_I = 0,
-	SHAPE_TYPE_O = 1,
-	SHAPE_TYPE_T = 2,
-	SHAPE_TYPE_J = 3,
-	SHAPE_TYPE_L = 4,
-	SHAPE_TYPE_S = 5,
-	SHAPE_TYPE_Z = 6
-} shape_type_t;
-
 typedef struct shape_t
 {
-	bool		 val[SHAPE_MAX_SIZE * SHAPE_MAX_SIZE];
-	vec2_t		 pos;
-	vec2_t		 prev_pos;
+	vec2i_t		 pos;
+	vec2i_t		 prev_pos;
 	shape_type_t type;
-	uint8_t		 padding_left;
-	uint8_t		 padding_right;
-	uint8_t		 padding_top;
-	uint8_t		 padding_bottom;
-	uint8_t		 width;
-	uint8_t		 height;
-	uint8_t		 shadow_pos_y;
-	bool		 shadow;
+	uint8_t		 rotation;
+	int16_t		 shadow_pos_y;
 } shape_t;
 
 #endif
\ No newline at end of file
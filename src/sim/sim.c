@@ -0,0 +1,386 @@
+#define _POSIX_C_SOURCE 200809L
+#include "../common.h"
+#include "../engine/bot.h"
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+#define SIM_MAX_THREADS 256
+
+// result of a single game
+typedef struct game_result_t
+{
+	uint32_t seed;
+	uint32_t shapes;
+	uint32_t lines;
+	uint32_t score;
+	uint32_t steps; // engine steps, every player action is one
+	bool	 game_over;
+} game_result_t;
+
+// pending games are the range [begin, end) of the seeds. The owner takes them
+// from the front, idle workers steal the back half
+typedef struct worker_t
+{
+	pthread_t		thread;
+	pthread_mutex_t lock;
+	uint32_t		begin;
+	uint32_t		end;
+	uint32_t		index;
+	uint32_t		games_played;
+	uint32_t		steals;
+} worker_t;
+
+typedef struct sim_config_t
+{
+	uint32_t	 threads;
+	uint32_t	 games;
+	uint32_t	 first_seed;
+	uint32_t	 max_shapes; // games are cut here, 0 for no limit
+	board_size_t board_size;
+	bool		 bag;
+	const char	*seeds_file;
+	const char	*csv_file;
+	const char	*json_file;
+} sim_config_t;
+
+static sim_config_t	  config;
+static uint32_t		 *seeds;
+static game_result_t *results;
+static worker_t		  workers[SIM_MAX_THREADS];
+
+static void		 parse_args(int argc, char *argv[]);
+static void		 load_seeds(void);
+static void		*run_worker(void *arg);
+static bool		 take_game(worker_t *worker, uint32_t *game);
+static bool		 steal_games(worker_t *thief);
+static void		 play_game(uint32_t seed, game_result_t *result);
+static void		 write_csv(void);
+static void		 write_summary(float64_t seconds);
+static float64_t get_current_time(void);
+
+int main(int argc, char *argv[])
+{
+	uint32_t games_per_worker;
+
+	parse_args(argc, argv);
+	load_seeds();
+
+	results = calloc(config.games, sizeof(game_result_t));
+	ASSERT(results);
+
+	games_per_worker = config.games / config.threads;
+	float64_t start	 = get_current_time();
+
+	for (uint32_t i = 0; i < config.threads; i++)
+	{
+		workers[i].index = i;
+		workers[i].begin = i * games_per_worker;
+		workers[i].end	 = i == config.threads - 1 ? config.games : (i + 1) * games_per_worker;
+		ASSERT(pthread_mutex_init(&workers[i].lock, NULL) == 0);
+	}
+
+	for (uint32_t i = 0; i < config.threads; i++)
+	{
+		ASSERT(pthread_create(&workers[i].thread, NULL, run_worker, &workers[i]) == 0);
+	}
+
+	for (uint32_t i = 0; i < config.threads; i++)
+	{
+		pthread_join(workers[i].thread, NULL);
+		pthread_mutex_destroy(&workers[i].lock);
+	}
+
+	float64_t seconds = get_current_time() - start;
+
+	write_csv();
+	write_summary(seconds);
+
+	free(results);
+	free(seeds);
+
+	return 0;
+}
+
+static void parse_args(int argc, char *argv[])
+{
+	long threads = sysconf(_SC_NPROCESSORS_ONLN);
+
+	config.threads	  = threads > 0 ? threads : 1;
+	config.games	  = 1000;
+	config.first_seed = 1;
+	config.max_shapes = 10000;
+	config.board_size = BOARD_SIZE_DEFAULT;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const char *option = argv[i];
+
+		if (strcmp(option, "--bag") == 0)
+		{
+			config.bag = true;
+			continue;
+		}
+
+		const char *value  = i + 1 < argc ? argv[++i] : NULL;
+		char	   *end	   = NULL;
+		long		number = value ? strtol(value, &end, 10) : -1;
+		bool		valid  = value && *end == '\0' && number >= 0;
+
+		if (strcmp(option, "--threads") == 0 && valid && number >= 1 && number <= SIM_MAX_THREADS)
+		{
+			config.threads = number;
+		}
+		else if (strcmp(option, "--games") == 0 && valid && number >= 1)
+		{
+			config.games = number;
+		}
+		else if (strcmp(option, "--seed") == 0 && valid)
+		{
+			config.first_seed = number;
+		}
+		else if (strcmp(option, "--max-shapes") == 0 && valid)
+		{
+			config.max_shapes = number;
+		}
+		else if (strcmp(option, "--board") == 0 && value && engine_parse_board_size(value, &config.board_size))
+		{
+		}
+		else if (strcmp(option, "--seeds-file") == 0 && value)
+		{
+			config.seeds_file = value;
+		}
+		else if (strcmp(option, "--csv") == 0 && value)
+		{
+			config.csv_file = value;
+		}
+		else if (strcmp(option, "--json") == 0 && value)
+		{
+			config.json_file = value;
+		}
+		else
+		{
+			fprintf(stderr,
+					"usage: %s [--threads <1-%d>] [--games <n>] [--seed <first seed>] [--seeds-file <file>]\n"
+					"          [--max-shapes <n, 0 for no limit>] [--bag] [--board <cols>x<rows>] [--csv <file>] [--json <file>]\n",
+					argv[0],
+					SIM_MAX_THREADS);
+			exit(1);
+		}
+	}
+}
+
+// one seed per line from --seeds-file, otherwise --games seeds from --seed on
+static void load_seeds(void)
+{
+	if (!config.seeds_file)
+	{
+		seeds = malloc(config.games * sizeof(uint32_t));
+		ASSERT(seeds);
+
+		for (uint32_t i = 0; i < config.games; i++)
+		{
+			seeds[i] = config.first_seed + i;
+		}
+
+		return;
+	}
+
+	FILE	*f		  = fopen(config.seeds_file, "r");
+	uint32_t capacity = 1024;
+	uint32_t seed;
+
+	ASSERT(f);
+	seeds		 = malloc(capacity * sizeof(uint32_t));
+	config.games = 0;
+	ASSERT(seeds);
+
+	while (fscanf(f, "%u", &seed) == 1)
+	{
+		if (config.games == capacity)
+		{
+			capacity *= 2;
+			seeds = realloc(seeds, capacity * sizeof(uint32_t));
+			ASSERT(seeds);
+		}
+
+		seeds[config.games++] = seed;
+	}
+
+	fclose(f);
+	ASSERT(config.games > 0);
+}
+
+static void *run_worker(void *arg)
+{
+	worker_t *worker = (worker_t *)arg;
+	uint32_t  game;
+
+	while (take_game(worker, &game) || (steal_games(worker) && take_game(worker, &game)))
+	{
+		play_game(seeds[game], &results[game]);
+		worker->games_played++;
+	}
+
+	return NULL;
+}
+
+static bool take_game(worker_t *worker, uint32_t *game)
+{
+	bool taken = false;
+
+	pthread_mutex_lock(&worker->lock);
+
+	if (worker->begin < worker->end)
+	{
+		*game = worker->begin++;
+		taken = true;
+	}
+
+	pthread_mutex_unlock(&worker->lock);
+
+	return taken;
+}
+
+// no games are ever added, so when nobody has any left to steal we're done
+static bool steal_games(worker_t *thief)
+{
+	for (uint32_t i = 1; i < config.threads; i++)
+	{
+		worker_t *victim = &workers[(thief->index + i) % config.threads];
+		uint32_t  begin	 = 0;
+		uint32_t  end	 = 0;
+
+		pthread_mutex_lock(&victim->lock);
+
+		if (victim->begin < victim->end)
+		{
+			begin		= victim->end - ((victim->end - victim->begin + 1) / 2);
+			end			= victim->end;
+			victim->end = begin;
+		}
+
+		pthread_mutex_unlock(&victim->lock);
+
+		if (begin < end)
+		{
+			pthread_mutex_lock(&thief->lock);
+			thief->begin = begin;
+			thief->end	 = end;
+			pthread_mutex_unlock(&thief->lock);
+			thief->steals++;
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static void play_game(uint32_t seed, game_result_t *result)
+{
+	engine_t engine;
+	bot_t	 bot;
+
+	engine_init(&engine, seed, config.bag ? RANDOMIZER_TYPE_BAG : RANDOMIZER_TYPE_UNIFORM, config.board_size);
+	bot_init(&bot);
+
+	result->seed = seed;
+
+	while (!engine_is_game_over(&engine) && (!config.max_shapes || engine.shapes_count < config.max_shapes))
+	{
+		result->steps += bot_play_shape(&bot, &engine);
+	}
+
+	result->shapes	  = engine.shapes_count;
+	result->lines	  = engine.lines;
+	result->score	  = engine.score;
+	result->game_over = engine_is_game_over(&engine);
+
+	engine_dispose(&engine);
+}
+
+static void write_csv(void)
+{
+	if (!config.csv_file)
+	{
+		return;
+	}
+
+	FILE *f = fopen(config.csv_file, "w");
+	ASSERT(f);
+
+	fprintf(f, "seed,shapes,lines,score,steps,game_over\n");
+
+	for (uint32_t i = 0; i < config.games; i++)
+	{
+		const game_result_t *result = &results[i];
+		fprintf(f, "%u,%u,%u,%u,%u,%d\n", result->seed, result->shapes, result->lines, result->score, result->steps, result->game_over);
+	}
+
+	fclose(f);
+}
+
+// totals, means and ranges of every game, printed and written as json
+static void write_summary(float64_t seconds)
+{
+	uint64_t shapes = 0, lines = 0, score = 0, steps = 0;
+	uint32_t game_overs = 0, steals = 0;
+	uint32_t min_lines = UINT32_MAX, max_lines = 0;
+	uint32_t min_shapes = UINT32_MAX, max_shapes = 0;
+
+	for (uint32_t i = 0; i < config.games; i++)
+	{
+		const game_result_t *result = &results[i];
+
+		shapes += result->shapes;
+		lines += result->lines;
+		score += result->score;
+		steps += result->steps;
+		game_overs += result->game_over;
+		min_lines  = result->lines < min_lines ? result->lines : min_lines;
+		max_lines  = result->lines > max_lines ? result->lines : max_lines;
+		min_shapes = result->shapes < min_shapes ? result->shapes : min_shapes;
+		max_shapes = result->shapes > max_shapes ? result->shapes : max_shapes;
+	}
+
+	for (uint32_t i = 0; i < config.threads; i++)
+	{
+		steals += workers[i].steals;
+	}
+
+	printf("games      %u (%u game over, %u cut at %u shapes, %s randomizer, %ux%u board)\n", config.games, game_overs, config.games - game_overs, config.max_shapes, config.bag ? "bag" : "uniform", config.board_size.cols, config.board_size.rows);
+	printf("threads    %u (%u steals)\n", config.threads, steals);
+	printf("shapes     %lu total, %.1f mean, %u-%u\n", (unsigned long)shapes, (float64_t)shapes / config.games, min_shapes, max_shapes);
+	printf("lines      %lu total, %.1f mean, %u-%u\n", (unsigned long)lines, (float64_t)lines / config.games, min_lines, max_lines);
+	printf("score      %lu total, %.1f mean\n", (unsigned long)score, (float64_t)score / config.games);
+	printf("steps      %lu total, %.1f mean\n", (unsigned long)steps, (float64_t)steps / config.games);
+	printf("time       %.2fs, %.1f games/s, %.0f shapes/s\n", seconds, config.games / seconds, shapes / seconds);
+
+	if (!config.json_file)
+	{
+		return;
+	}
+
+	FILE *f = fopen(config.json_file, "w");
+	ASSERT(f);
+
+	fprintf(f, "{\n");
+	fprintf(f, "\t\"games\": %u,\n\t\"game_overs\": %u,\n\t\"max_shapes\": %u,\n\t\"randomizer\": \"%s\",\n", config.games, game_overs, config.max_shapes, config.bag ? "bag" : "uniform");
+	fprintf(f, "\t\"board\": { \"cols\": %u, \"rows\": %u },\n", config.board_size.cols, config.board_size.rows);
+	fprintf(f, "\t\"threads\": %u,\n\t\"steals\": %u,\n", config.threads, steals);
+	fprintf(f, "\t\"shapes\": { \"total\": %lu, \"mean\": %.3f, \"min\": %u, \"max\": %u },\n", (unsigned long)shapes, (float64_t)shapes / config.games, min_shapes, max_shapes);
+	fprintf(f, "\t\"lines\": { \"total\": %lu, \"mean\": %.3f, \"min\": %u, \"max\": %u },\n", (unsigned long)lines, (float64_t)lines / config.games, min_lines, max_lines);
+	fprintf(f, "\t\"score\": { \"total\": %lu, \"mean\": %.3f },\n", (unsigned long)score, (float64_t)score / config.games);
+	fprintf(f, "\t\"steps\": { \"total\": %lu, \"mean\": %.3f },\n", (unsigned long)steps, (float64_t)steps / config.games);
+	fprintf(f, "\t\"seconds\": %.6f\n}\n", seconds);
+	fclose(f);
+}
+
+static float64_t get_current_time(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return now.tv_sec + (now.tv_nsec / 1e9);
+}
\ No newline at end of file
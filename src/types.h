@@ -0,0 +1,83 @@
+#ifndef TYPES_H
+#define TYPES_H
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// TYPES
+typedef float  float32_t;
+typedef double float64_t;
+
+typedef enum color_pair_t
+{
+	COLOR_PAIR_RED_DEFAULT	   = 1,
+	COLOR_PAIR_BLUE_DEFAULT	   = 2,
+	COLOR_PAIR_GREEN_DEFAULT   = 3,
+	COLOR_PAIR_YELLOW_DEFAULT  = 4,
+	COLOR_PAIR_ORANGE_DEFAULT  = 5,
+	COLOR_PAIR_CYAN_DEFAULT	   = 6,
+	COLOR_PAIR_MAGENTA_DEFAULT = 7,
+	COLOR_PAIR_WHITE_DEFAULT   = 8,
+
+	COLOR_PAIR_RED_LOW	  = 10,
+	COLOR_PAIR_RED_MEDIUM = 11,
+	COLOR_PAIR_RED_HIGH	  = 12,
+
+	COLOR_PAIR_BLUE_LOW	   = 20,
+	COLOR_PAIR_BLUE_MEDIUM = 21,
+	COLOR_PAIR_BLUE_HIGH   = 22,
+
+	COLOR_PAIR_GREEN_LOW	= 30,
+	COLOR_PAIR_GREEN_MEDIUM = 31,
+	COLOR_PAIR_GREEN_HIGH	= 32,
+
+	COLOR_PAIR_YELLOW_LOW	 = 40,
+	COLOR_PAIR_YELLOW_MEDIUM = 41,
+	COLOR_PAIR_YELLOW_HIGH	 = 42,
+
+	COLOR_PAIR_ORANGE_LOW	 = 50,
+	COLOR_PAIR_ORANGE_MEDIUM = 51,
+	COLOR_PAIR_ORANGE_HIGH	 = 52,
+
+	COLOR_PAIR_CYAN_LOW	   = 60,
+	COLOR_PAIR_CYAN_MEDIUM = 61,
+	COLOR_PAIR_CYAN_HIGH   = 62,
+
+	COLOR_PAIR_MAGENTA_LOW	  = 70,
+	COLOR_PAIR_MAGENTA_MEDIUM = 71,
+	COLOR_PAIR_MAGENTA_HIGH	  = 72,
+
+	COLOR_PAIR_WHITE_LOW	= 80,
+	COLOR_PAIR_WHITE_MEDIUM = 81,
+	COLOR_PAIR_WHITE_HIGH	= 82,
+
+	COLOR_PAIR_BLUE_BK = 90,
+	COLOR_PAIR_RED_BK  = 91
+} color_pair_t;
+
+typedef struct score_t
+{
+	uint16_t current;
+	uint16_t record;
+	// next members are used to show animated score on screen
+	uint16_t current_label;
+	uint16_t record_label;
+} score_t;
+
+typedef struct vec2_t
+{
+	float32_t x;
+	float32_t y;
+} vec2_t;
+
+typedef struct vec2i_t
+{
+	int16_t x;
+	int16_t y;
+} vec2i_t;
+
+#endif
\ No newline at end of file
@@ -0,0 +1,263 @@
+#define _POSIX_C_SOURCE 200809L
+#include "versus.h"
+#include <pthread.h>
+#include <time.h>
+
+// rows pushed in at once, hole_x is the column left empty
+typedef struct garbage_t
+{
+	uint8_t rows;
+	uint8_t hole_x;
+} garbage_t;
+
+typedef SPSC_QUEUE_T(uint8_t, VERSUS_ACTIONS_CAPACITY) actions_queue_t;
+typedef SPSC_QUEUE_T(garbage_t, VERSUS_GARBAGE_CAPACITY) garbage_queue_t;
+
+// the game is only touched by the player's thread. actions are pushed by the
+// screen and garbage by the opponent's thread, the view is under view_lock
+typedef struct player_t
+{
+	pthread_t		thread;
+	pthread_mutex_t view_lock;
+	versus_view_t	view;
+	engine_t		engine;
+	actions_queue_t actions;
+	garbage_queue_t garbage;
+	random_t		holes;
+	uint32_t		garbage_sent;
+	uint32_t		garbage_received;
+	uint32_t		steps;
+	uint8_t			index;
+} player_t;
+
+static const uint8_t   c_garbage_rows[] = { 0, 0, 1, 2, 4 }; // by rows cleared at once
+static const float32_t c_step_interval	= 0.01;
+static const float32_t c_max_delta_time = 1.0;
+
+static player_t players[VERSUS_PLAYERS];
+static bool		started = false;
+// shared with the players' threads, atomically. Threads wait on unfrozen
+// while paused or over, it's signalled under frozen_lock when that can end
+static bool			   running;
+static bool			   paused;
+static bool			   over;
+static pthread_mutex_t frozen_lock;
+static pthread_cond_t  unfrozen;
+
+static void		*run_player(void *arg);
+static void		 wait_while_frozen(void);
+static void		 step_player(player_t *player, float32_t delta_time);
+static void		 publish_view(player_t *player);
+static float64_t get_current_time(void);
+
+// both players get the same shapes on the same board size
+void versus_start(uint32_t seed, randomizer_type_t randomizer_type, board_size_t board_size)
+{
+	ASSERT(!started);
+
+	running = true;
+	paused	= false;
+	over	= false;
+	ASSERT(pthread_mutex_init(&frozen_lock, NULL) == 0);
+	ASSERT(pthread_cond_init(&unfrozen, NULL) == 0);
+
+	for (uint8_t i = 0; i < VERSUS_PLAYERS; i++)
+	{
+		player_t *player = &players[i];
+
+		player->index			 = i;
+		player->garbage_sent	 = 0;
+		player->garbage_received = 0;
+		player->steps			 = 0;
+
+		engine_init(&player->engine, seed, randomizer_type, board_size);
+		random_seed(&player->holes, ((uint64_t)seed << 8) | i);
+		SPSC_QUEUE_INIT(player->actions);
+		SPSC_QUEUE_INIT(player->garbage);
+		ASSERT(pthread_mutex_init(&player->view_lock, NULL) == 0);
+		publish_view(player);
+	}
+
+	for (uint8_t i = 0; i < VERSUS_PLAYERS; i++)
+	{
+		ASSERT(pthread_create(&players[i].thread, NULL, run_player, &players[i]) == 0);
+	}
+
+	started = true;
+}
+
+void versus_stop(void)
+{
+	if (!started)
+	{
+		return;
+	}
+
+	pthread_mutex_lock(&frozen_lock);
+	__atomic_store_n(&running, false, __ATOMIC_RELEASE);
+	pthread_cond_broadcast(&unfrozen);
+	pthread_mutex_unlock(&frozen_lock);
+
+	for (uint8_t i = 0; i < VERSUS_PLAYERS; i++)
+	{
+		pthread_join(players[i].thread, NULL);
+		pthread_mutex_destroy(&players[i].view_lock);
+		engine_dispose(&players[i].engine);
+	}
+
+	pthread_cond_destroy(&unfrozen);
+	pthread_mutex_destroy(&frozen_lock);
+
+	started = false;
+}
+
+// someone topped out, both games are frozen
+bool versus_is_over(void)
+{
+	return __atomic_load_n(&over, __ATOMIC_ACQUIRE);
+}
+
+// time stands still for both, actions are dropped
+void versus_set_paused(bool value)
+{
+	pthread_mutex_lock(&frozen_lock);
+	__atomic_store_n(&paused, value, __ATOMIC_RELEASE);
+	pthread_cond_broadcast(&unfrozen);
+	pthread_mutex_unlock(&frozen_lock);
+}
+
+// applied on the player's next step. False when its queue is full
+bool versus_push_action(uint8_t player, player_action_t action)
+{
+	ASSERT(player < VERSUS_PLAYERS);
+
+	return SPSC_QUEUE_PUSH(players[player].actions, (uint8_t)action);
+}
+
+void versus_get_view(uint8_t player, versus_view_t *view)
+{
+	ASSERT(player < VERSUS_PLAYERS);
+
+	const versus_view_t *source = &players[player].view;
+
+	pthread_mutex_lock(&players[player].view_lock);
+	engine_copy(&view->engine, &source->engine);
+	view->garbage_sent	   = source->garbage_sent;
+	view->garbage_received = source->garbage_received;
+	view->steps			   = source->steps;
+	pthread_mutex_unlock(&players[player].view_lock);
+}
+
+// steps the game every c_step_interval, whatever the other player's does.
+// Sleeps without waking up while paused or over
+static void *run_player(void *arg)
+{
+	player_t	   *player	  = (player_t *)arg;
+	struct timespec interval  = { .tv_sec = 0, .tv_nsec = (long)(c_step_interval * 1e9) };
+	float64_t		last_time = get_current_time();
+	uint8_t			action;
+
+	while (__atomic_load_n(&running, __ATOMIC_ACQUIRE))
+	{
+		nanosleep(&interval, NULL);
+
+		float64_t now		 = get_current_time();
+		float32_t delta_time = now - last_time;
+		last_time			 = now;
+
+		if (__atomic_load_n(&paused, __ATOMIC_ACQUIRE) || __atomic_load_n(&over, __ATOMIC_ACQUIRE))
+		{
+			wait_while_frozen();
+			last_time = get_current_time();
+
+			while (SPSC_QUEUE_POP(player->actions, &action))
+			{
+			}
+
+			continue;
+		}
+
+		step_player(player, delta_time < c_max_delta_time ? delta_time : c_max_delta_time);
+	}
+
+	return NULL;
+}
+
+// until versus_set_paused(false) or versus_stop
+static void wait_while_frozen(void)
+{
+	pthread_mutex_lock(&frozen_lock);
+
+	while (__atomic_load_n(&running, __ATOMIC_ACQUIRE) &&
+		   (__atomic_load_n(&paused, __ATOMIC_ACQUIRE) || __atomic_load_n(&over, __ATOMIC_ACQUIRE)))
+	{
+		pthread_cond_wait(&unfrozen, &frozen_lock);
+	}
+
+	pthread_mutex_unlock(&frozen_lock);
+}
+
+// garbage received first, then every action in order before time moves on
+// (as the stage does). Rows cleared send garbage to the opponent
+static void step_player(player_t *player, float32_t delta_time)
+{
+	player_t *opponent = &players[(player->index + 1) % VERSUS_PLAYERS];
+	uint32_t  lines	   = player->engine.lines;
+	garbage_t garbage;
+	uint8_t	  action;
+
+	// waits while rows are being cleared, the queue keeps it
+	while (!engine_is_clearing_rows(&player->engine) && SPSC_QUEUE_POP(player->garbage, &garbage))
+	{
+		engine_add_garbage(&player->engine, garbage.rows, garbage.hole_x);
+		player->garbage_received += garbage.rows;
+	}
+
+	while (SPSC_QUEUE_POP(player->actions, &action))
+	{
+		engine_step(&player->engine, action, 0);
+	}
+
+	engine_step(&player->engine, PLAYER_ACTION_IDLE, delta_time);
+
+	uint32_t cleared = player->engine.lines - lines;
+	garbage.rows	 = c_garbage_rows[cleared < 4 ? cleared : 4];
+
+	if (garbage.rows > 0)
+	{
+		garbage.hole_x = random_below(&player->holes, player->engine.board_size.cols);
+
+		// a full queue is an opponent far behind, those rows are lost
+		if (SPSC_QUEUE_PUSH(opponent->garbage, garbage))
+		{
+			player->garbage_sent += garbage.rows;
+		}
+	}
+
+	player->steps++;
+	publish_view(player);
+
+	// after the view, so the screen never sees a match over without a loser
+	if (engine_is_game_over(&player->engine))
+	{
+		__atomic_store_n(&over, true, __ATOMIC_RELEASE);
+	}
+}
+
+static void publish_view(player_t *player)
+{
+	pthread_mutex_lock(&player->view_lock);
+	engine_copy(&player->view.engine, &player->engine);
+	player->view.garbage_sent	  = player->garbage_sent;
+	player->view.garbage_received = player->garbage_received;
+	player->view.steps			  = player->steps;
+	pthread_mutex_unlock(&player->view_lock);
+}
+
+static float64_t get_current_time(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return now.tv_sec + (now.tv_nsec / 1e9);
+}
\ No newline at end of file
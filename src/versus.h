@@ -0,0 +1,32 @@
+#ifndef VERSUS_H
+#define VERSUS_H
+
+#include "engine/engine.h"
+
+// two players on one keyboard, each game stepped by its own thread so one's
+// heavy frames (e.g. rows being cleared) never hold the other back. Actions
+// come in and garbage rows go to the opponent through lock free queues (see
+// spsc_queue.h). The screen draws copies of the games (only the board rows in
+// use, see engine_copy), taken under a lock held only while copying. The
+// match is over when someone tops out
+#define VERSUS_PLAYERS 2
+#define VERSUS_ACTIONS_CAPACITY 64 // per player, a power of two
+#define VERSUS_GARBAGE_CAPACITY 16 // batches sent and not yet received, a power of two
+
+// a player's game as last stepped
+typedef struct versus_view_t
+{
+	engine_t engine;
+	uint32_t garbage_sent; // rows
+	uint32_t garbage_received;
+	uint32_t steps; // changes when the game does
+} versus_view_t;
+
+void versus_start(uint32_t seed, randomizer_type_t randomizer_type, board_size_t board_size);
+void versus_stop(void);
+bool versus_is_over(void);
+void versus_set_paused(bool value);
+bool versus_push_action(uint8_t player, player_action_t action);
+void versus_get_view(uint8_t player, versus_view_t *view);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,280 @@
+#define _POSIX_C_SOURCE 200809L
+#include "watch.h"
+#include "data_structures/memory.h"
+#include <errno.h>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+// fits a keyframe, the biggest message a publisher sends
+#define WATCH_BUFFER_SIZE (BROADCAST_RING_SIZE / 4)
+
+static int32_t read_message(watch_t *watch, uint32_t offset);
+static bool	   apply_records(watch_t *watch, const uint8_t *records, uint32_t size);
+static bool	   resize_panel(watch_panel_t *panel, uint16_t rows, uint16_t cols);
+
+void watch_init(watch_t *watch)
+{
+	memset(watch, 0, sizeof(watch_t));
+	watch->fd = -1;
+}
+
+// false when nobody is broadcasting on path
+bool watch_connect(watch_t *watch, const char *path)
+{
+#ifdef __linux__
+	struct sockaddr_un address = { .sun_family = AF_UNIX };
+
+	watch_close(watch);
+
+	if (strlen(path) >= sizeof(address.sun_path))
+	{
+		return false;
+	}
+
+	memcpy(address.sun_path, path, strlen(path));
+	watch->fd = socket(AF_UNIX, SOCK_STREAM, 0);
+
+	if (watch->fd < 0)
+	{
+		return false;
+	}
+
+	if (connect(watch->fd, (struct sockaddr *)&address, sizeof(address)) != 0)
+	{
+		watch_close(watch);
+		return false;
+	}
+
+	fcntl(watch->fd, F_SETFL, O_NONBLOCK);
+
+	if (!watch->buffer)
+	{
+		watch->buffer = (uint8_t *)memory_alloc(WATCH_BUFFER_SIZE);
+		ASSERT(watch->buffer);
+	}
+
+	return true;
+#else
+	(void)watch;
+	(void)path;
+
+	return false;
+#endif
+}
+
+void watch_dispose(watch_t *watch)
+{
+	watch_close(watch);
+	memory_free(watch->buffer);
+
+	for (uint8_t i = 0; i < BROADCAST_PANEL_COUNT; i++)
+	{
+		memory_free(watch->panels[i].cells);
+	}
+
+	watch_init(watch);
+}
+
+// the panels are kept, to be shown until the next keyframe
+void watch_close(watch_t *watch)
+{
+#ifdef __linux__
+	if (watch->fd >= 0)
+	{
+		close(watch->fd);
+	}
+#endif
+
+	watch->fd		   = -1;
+	watch->buffer_size = 0;
+	watch->synced	   = false;
+}
+
+// every message received so far is applied. False when the connection is
+// gone, the publisher quit or sent something that isn't a broadcast
+bool watch_update(watch_t *watch)
+{
+#ifdef __linux__
+	if (watch->fd < 0)
+	{
+		return false;
+	}
+
+	while (true)
+	{
+		ssize_t received = recv(watch->fd, &watch->buffer[watch->buffer_size], WATCH_BUFFER_SIZE - watch->buffer_size, 0);
+
+		if (received < 0 && errno == EINTR)
+		{
+			continue;
+		}
+
+		if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+		{
+			return true;
+		}
+
+		if (received <= 0)
+		{
+			watch_close(watch);
+			return false;
+		}
+
+		watch->buffer_size += received;
+
+		// complete messages, what's left of the last one is kept for later
+		uint32_t offset = 0;
+		int32_t	 size;
+
+		while ((size = read_message(watch, offset)) > 0)
+		{
+			offset += size;
+		}
+
+		if (size < 0)
+		{
+			watch_close(watch);
+			return false;
+		}
+
+		memmove(watch->buffer, &watch->buffer[offset], watch->buffer_size - offset);
+		watch->buffer_size -= offset;
+	}
+#else
+	(void)watch;
+
+	return false;
+#endif
+}
+
+// size of the message at offset, once applied. 0 when it isn't complete
+// yet, -1 when it's invalid
+static int32_t read_message(watch_t *watch, uint32_t offset)
+{
+	broadcast_message_header_t header;
+	uint32_t				   available = watch->buffer_size - offset;
+
+	if (available < sizeof(header))
+	{
+		return 0;
+	}
+
+	memcpy(&header, &watch->buffer[offset], sizeof(header));
+
+	if (memcmp(header.magic, BROADCAST_MAGIC, sizeof(header.magic)) != 0 ||
+		header.version != BROADCAST_VERSION ||
+		header.size > WATCH_BUFFER_SIZE - sizeof(header))
+	{
+		return -1;
+	}
+
+	if (available < sizeof(header) + header.size)
+	{
+		return 0;
+	}
+
+	// deltas before the first keyframe are of panels not seen yet
+	if (header.type == BROADCAST_MESSAGE_KEYFRAME || watch->synced)
+	{
+		if (!apply_records(watch, &watch->buffer[offset + sizeof(header)], header.size))
+		{
+			return -1;
+		}
+
+		watch->synced = true;
+		watch->frame  = header.frame;
+		watch->messages++;
+	}
+
+	return sizeof(header) + header.size;
+}
+
+static bool apply_records(watch_t *watch, const uint8_t *records, uint32_t size)
+{
+	broadcast_record_header_t header;
+
+	for (uint32_t offset = 0; offset < size;)
+	{
+		if (size - offset < sizeof(header))
+		{
+			return false;
+		}
+
+		memcpy(&header, &records[offset], sizeof(header));
+		offset += sizeof(header);
+
+		uint32_t data_size = header.count;
+
+		if (header.type == BROADCAST_RECORD_SIZE)
+		{
+			data_size = 0;
+		}
+		else if (header.type == BROADCAST_RECORD_CELLS)
+		{
+			data_size = header.count * sizeof(uint16_t);
+		}
+
+		if (header.panel >= BROADCAST_PANEL_COUNT || size - offset < data_size)
+		{
+			return false;
+		}
+
+		watch_panel_t *panel = &watch->panels[header.panel];
+
+		if (header.type == BROADCAST_RECORD_SIZE)
+		{
+			if (!resize_panel(panel, header.y, header.x))
+			{
+				return false;
+			}
+		}
+		else if (header.type == BROADCAST_RECORD_CELLS)
+		{
+			if (header.y >= panel->rows || header.x + header.count > panel->cols)
+			{
+				return false;
+			}
+
+			memcpy(&panel->cells[panel->cols * header.y + header.x], &records[offset], data_size);
+		}
+		else if (header.type == BROADCAST_RECORD_HUD)
+		{
+			if (header.count != sizeof(watch->hud))
+			{
+				return false;
+			}
+
+			memcpy(&watch->hud, &records[offset], sizeof(watch->hud));
+			watch->hud.user[BROADCAST_USER_SIZE - 1] = CH_EOS;
+		}
+		else
+		{
+			return false;
+		}
+
+		offset += data_size;
+	}
+
+	return true;
+}
+
+// reallocated only when the size changes, keyframes send every cell anyway
+static bool resize_panel(watch_panel_t *panel, uint16_t rows, uint16_t cols)
+{
+	if (rows != panel->rows || cols != panel->cols)
+	{
+		memory_free(panel->cells);
+		panel->cells = (uint16_t *)memory_calloc((uint32_t)rows * cols, sizeof(uint16_t));
+		panel->rows	 = panel->cells ? rows : 0;
+		panel->cols	 = panel->cells ? cols : 0;
+
+		return panel->cells || (uint32_t)rows * cols == 0;
+	}
+
+	return true;
+}
\ No newline at end of file
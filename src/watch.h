@@ -0,0 +1,34 @@
+#ifndef WATCH_H
+#define WATCH_H
+
+#include "broadcast.h"
+
+// the watcher's end of a broadcast (see broadcast.h): messages are read as
+// they come and applied to a copy of the publisher's panels, starting at the
+// first keyframe
+typedef struct watch_panel_t
+{
+	uint16_t *cells; // encoded, see broadcast_decode_cell
+	uint16_t  rows;
+	uint16_t  cols;
+} watch_panel_t;
+
+typedef struct watch_t
+{
+	int				fd; // -1 when not connected
+	uint8_t		   *buffer;
+	uint32_t		buffer_size;
+	watch_panel_t	panels[BROADCAST_PANEL_COUNT];
+	broadcast_hud_t hud;
+	bool			synced; // a keyframe was applied
+	uint32_t		frame;	// of the last message applied
+	uint32_t		messages;
+} watch_t;
+
+void watch_init(watch_t *watch);
+void watch_dispose(watch_t *watch);
+bool watch_connect(watch_t *watch, const char *path);
+void watch_close(watch_t *watch);
+bool watch_update(watch_t *watch);
+
+#endif
\ No newline at end of file